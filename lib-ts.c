@@ -10,7 +10,658 @@
 
 #define TE_LGR_USER     "Onload Library"
 
+#include <stdio.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/queue.h>
+#include <sys/stat.h>
+#include <time.h>
+
 #include "lib-ts.h"
+#include "lib-ts_addrs.h"
+#include "lib-ts_serial.h"
+#include "lib-ts_timing.h"
+#include "lib-ts_tune.h"
+
+/** Length of MD5 digest in hex representation */
+#define LIBTS_DIGEST_LEN 32
+
+/** Default location of the content-addressed files cache on agents */
+#define LIBTS_COPY_CACHE_DIR_DEF "/var/tmp/libts_copy_cache"
+
+/** Statistics of the content-addressed files transfer */
+typedef struct copy_cache_stats {
+    unsigned int        hits;           /**< Transfers avoided */
+    unsigned int        misses;         /**< Files actually put */
+    unsigned long long  bytes_saved;    /**< Bytes not transferred */
+} copy_cache_stats;
+
+/** Accumulated statistics of the content-addressed files transfer */
+static copy_cache_stats copy_cache_total;
+
+/** Lock protecting @p copy_cache_total */
+static pthread_mutex_t copy_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Account a content-addressed file transfer.
+ *
+ * @param hit       Whether the transfer is avoided.
+ * @param size      File size.
+ *
+ * @return Updated statistics.
+ */
+static copy_cache_stats
+copy_cache_stats_update(te_bool hit, off_t size)
+{
+    copy_cache_stats stats;
+
+    pthread_mutex_lock(&copy_cache_lock);
+    if (hit)
+    {
+        copy_cache_total.hits++;
+        copy_cache_total.bytes_saved += size;
+    }
+    else
+    {
+        copy_cache_total.misses++;
+    }
+    stats = copy_cache_total;
+    pthread_mutex_unlock(&copy_cache_lock);
+
+    return stats;
+}
+
+/** Memoized value of a derived fact */
+typedef struct memo_entry {
+    SLIST_ENTRY(memo_entry) links;  /**< List links */
+    char                   *key;    /**< Key */
+    char                   *value;  /**< Value */
+} memo_entry;
+
+/** Memoized values */
+static SLIST_HEAD(, memo_entry) memo_entries =
+    SLIST_HEAD_INITIALIZER(memo_entries);
+
+/** Lock protecting @p memo_entries */
+static pthread_mutex_t memo_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Find memoized value by key. Should be called under @p memo_lock.
+ *
+ * @param key       Key.
+ *
+ * @return Entry or @c NULL if there is no value for the key.
+ */
+static memo_entry *
+memo_find(const char *key)
+{
+    memo_entry *entry;
+
+    SLIST_FOREACH(entry, &memo_entries, links)
+    {
+        if (strcmp(entry->key, key) == 0)
+            return entry;
+    }
+
+    return NULL;
+}
+
+/* See description in lib-ts.h */
+te_errno
+libts_memo_get(const char *key, char **value)
+{
+    memo_entry *entry;
+    te_errno    rc = 0;
+
+    pthread_mutex_lock(&memo_lock);
+    entry = memo_find(key);
+    if (entry == NULL)
+    {
+        rc = TE_RC(TE_TAPI, TE_ENOENT);
+    }
+    else
+    {
+        *value = strdup(entry->value);
+        if (*value == NULL)
+            rc = TE_RC(TE_TAPI, TE_ENOMEM);
+    }
+    pthread_mutex_unlock(&memo_lock);
+
+    return rc;
+}
+
+/* See description in lib-ts.h */
+te_errno
+libts_memo_set(const char *key, const char *value)
+{
+    memo_entry *entry;
+    char       *dup = strdup(value);
+    te_errno    rc = 0;
+
+    if (dup == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+
+    pthread_mutex_lock(&memo_lock);
+    entry = memo_find(key);
+    if (entry != NULL)
+    {
+        free(entry->value);
+        entry->value = dup;
+    }
+    else if ((entry = calloc(1, sizeof(*entry))) == NULL ||
+             (entry->key = strdup(key)) == NULL)
+    {
+        free(entry);
+        free(dup);
+        rc = TE_RC(TE_TAPI, TE_ENOMEM);
+    }
+    else
+    {
+        entry->value = dup;
+        SLIST_INSERT_HEAD(&memo_entries, entry, links);
+    }
+    pthread_mutex_unlock(&memo_lock);
+
+    return rc;
+}
+
+/* See description in lib-ts.h */
+void
+libts_memo_invalidate(void)
+{
+    memo_entry *entry;
+
+    pthread_mutex_lock(&memo_lock);
+    while ((entry = SLIST_FIRST(&memo_entries)) != NULL)
+    {
+        SLIST_REMOVE_HEAD(&memo_entries, links);
+        free(entry->key);
+        free(entry->value);
+        free(entry);
+    }
+    pthread_mutex_unlock(&memo_lock);
+
+    libts_addrs_invalidate();
+}
+
+/* See description in lib-ts.h */
+double
+libts_monotonic_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000. + ts.tv_nsec / 1e6;
+}
+
+/* See description in lib-ts.h */
+unsigned int
+libts_getenv_uint(const char *name, unsigned int min, unsigned int max,
+                  unsigned int def)
+{
+    const char     *val = getenv(name);
+    char           *end;
+    unsigned long   n;
+
+    if (val == NULL || *val == '\0')
+        return def;
+
+    errno = 0;
+    n = strtoul(val, &end, 0);
+    if (errno != 0 || *end != '\0' || val[0] == '-' || n < min || n > max)
+    {
+        WARN("Invalid %s value '%s', use %u", name, val, def);
+        return def;
+    }
+
+    return n;
+}
+
+/* See description in lib-ts.h */
+te_errno
+libts_shell_quote(te_string *str, const char *arg)
+{
+    size_t      len;
+    te_errno    rc;
+
+    rc = te_string_append(str, "'");
+    while (rc == 0 && *arg != '\0')
+    {
+        len = strcspn(arg, "'");
+        rc = te_string_append(str, "%.*s", (int)len, arg);
+        arg += len;
+        if (rc == 0 && *arg == '\'')
+        {
+            /* Close quotes, put escaped quote and open quotes again */
+            rc = te_string_append(str, "'\\''");
+            arg++;
+        }
+    }
+    if (rc == 0)
+        rc = te_string_append(str, "'");
+
+    return rc;
+}
+
+/* See description in lib-ts.h */
+te_errno
+libts_ta_shell(const char *ta, int *status, const char *fmt, ...)
+{
+    te_string   cmd = TE_STRING_INIT;
+    va_list     ap;
+    int         rc2;
+    te_errno    rc;
+
+    va_start(ap, fmt);
+    rc = te_string_append_va(&cmd, fmt, ap);
+    va_end(ap);
+    if (rc != 0)
+    {
+        te_string_free(&cmd);
+        return rc;
+    }
+
+    rc = rcf_ta_call(ta, 0, "shell", &rc2, 1, TRUE, cmd.ptr);
+    if (rc != 0)
+    {
+        ERROR("Failed to call 'shell' on %s: %r", ta, rc);
+    }
+    else if (status != NULL)
+    {
+        *status = rc2;
+    }
+    else if (rc2 != 0)
+    {
+        ERROR("Failed to execute '%s' on %s: exit status %d",
+              cmd.ptr, ta, rc2);
+        rc = TE_RC(TE_TAPI, TE_ESHCMD);
+    }
+
+    te_string_free(&cmd);
+    return rc;
+}
+
+/* See description in lib-ts.h */
+te_errno
+libts_ta_shell_get(const char *ta, char **out, const char *fmt, ...)
+{
+    static unsigned int counter = 0;
+
+    te_string   cmd = TE_STRING_INIT;
+    char        tmp[RCF_MAX_PATH];
+    va_list     ap;
+    te_errno    rc;
+    te_errno    rc2;
+
+    snprintf(tmp, sizeof(tmp), "/tmp/libts_out_%d_%u",
+             (int)getpid(), __sync_fetch_and_add(&counter, 1));
+
+    va_start(ap, fmt);
+    rc = te_string_append_va(&cmd, fmt, ap);
+    va_end(ap);
+    if (rc != 0)
+    {
+        te_string_free(&cmd);
+        return rc;
+    }
+
+    rc = libts_ta_shell(ta, NULL, "( %s ) >%s 2>/dev/null", cmd.ptr, tmp);
+    te_string_free(&cmd);
+    if (rc == 0)
+        rc = tapi_file_read_ta(ta, tmp, out);
+
+    rc2 = rcf_ta_del_file(ta, 0, tmp);
+    if (rc2 != 0)
+        WARN("Failed to remove '%s' on %s: %r", tmp, ta, rc2);
+
+    return rc;
+}
+
+/**
+ * Calculate MD5 digest of a file on the engine.
+ *
+ * @param path      File name.
+ * @param digest    Where to put the digest in hex (at least
+ *                  @c LIBTS_DIGEST_LEN + 1 bytes).
+ *
+ * @return Status code.
+ */
+static te_errno
+engine_file_digest(const char *path, char *digest)
+{
+    te_string   cmd = TE_STRING_INIT;
+    FILE       *f;
+    int         n;
+    te_errno    rc;
+
+    rc = te_string_append(&cmd, "md5sum ");
+    if (rc == 0)
+        rc = libts_shell_quote(&cmd, path);
+    if (rc == 0)
+        rc = te_string_append(&cmd, " 2>/dev/null");
+    if (rc != 0)
+    {
+        te_string_free(&cmd);
+        return rc;
+    }
+
+    f = popen(cmd.ptr, "r");
+    te_string_free(&cmd);
+    if (f == NULL)
+        return TE_RC(TE_TAPI, te_rc_os2te(errno));
+
+    n = fscanf(f, "%32s", digest);
+    pclose(f);
+    if (n != 1 || strlen(digest) != LIBTS_DIGEST_LEN)
+        return TE_RC(TE_TAPI, TE_EFAIL);
+
+    return 0;
+}
+
+/**
+ * Calculate MD5 digest of a file on a test agent.
+ *
+ * @param ta        Test Agent name.
+ * @param path      File name.
+ * @param digest    Where to put the digest in hex (at least
+ *                  @c LIBTS_DIGEST_LEN + 1 bytes), it is set to empty
+ *                  string if the file does not exist.
+ *
+ * @return Status code.
+ */
+static te_errno
+ta_file_digest(const char *ta, const char *path, char *digest)
+{
+    te_string   path_q = TE_STRING_INIT;
+    char       *out = NULL;
+    te_errno    rc;
+
+    digest[0] = '\0';
+    rc = libts_shell_quote(&path_q, path);
+    if (rc == 0)
+    {
+        rc = libts_ta_shell_get(ta, &out, "md5sum %s || true",
+                                path_q.ptr);
+    }
+    te_string_free(&path_q);
+    if (rc != 0)
+        return rc;
+
+    if (sscanf(out, "%32s", digest) != 1 ||
+        strlen(digest) != LIBTS_DIGEST_LEN)
+    {
+        digest[0] = '\0';
+    }
+    free(out);
+
+    return 0;
+}
+
+/**
+ * Put file to a test agent compressed with gzip and decompress it on
+ * the agent.
+ *
+ * @param ta        Test Agent name.
+ * @param src       Source file name on the engine.
+ * @param dst       Destination file name on the agent.
+ * @param done      Set to @c TRUE if the file is put, @c FALSE if
+ *                  the compressed transfer is not supported and the file
+ *                  should be put as is.
+ *
+ * @return Status code.
+ */
+static te_errno
+put_file_compressed(const char *ta, const char *src, const char *dst,
+                    te_bool *done)
+{
+    const char *tmp_dir = getenv("TE_TMP");
+    te_string   cmd = TE_STRING_INIT;
+    te_string   gz_q = TE_STRING_INIT;
+    te_string   dst_q = TE_STRING_INIT;
+    char        tmp[RCF_MAX_PATH];
+    char        dst_gz[RCF_MAX_PATH];
+    struct stat src_st;
+    struct stat gz_st;
+    double      start = libts_monotonic_ms();
+    int         status;
+    int         fd;
+    te_errno    rc;
+
+    *done = FALSE;
+
+    rc = libts_ta_shell(ta, &status, "command -v gzip >/dev/null");
+    if (rc != 0)
+        return rc;
+    if (status != 0)
+    {
+        WARN("gzip is not available on %s, put '%s' uncompressed",
+             ta, src);
+        return 0;
+    }
+
+    if (tmp_dir == NULL)
+        tmp_dir = "/tmp";
+    snprintf(tmp, sizeof(tmp), "%s/libts_put_XXXXXX", tmp_dir);
+    fd = mkstemp(tmp);
+    if (fd < 0)
+    {
+        WARN("Failed to create temporary file in %s, put '%s' "
+             "uncompressed", tmp_dir, src);
+        return 0;
+    }
+    close(fd);
+
+    rc = te_string_append(&cmd, "gzip -c -1 ");
+    if (rc == 0)
+        rc = libts_shell_quote(&cmd, src);
+    if (rc == 0)
+        rc = te_string_append(&cmd, " >");
+    if (rc == 0)
+        rc = libts_shell_quote(&cmd, tmp);
+    if (rc != 0 || system(cmd.ptr) != 0 || stat(src, &src_st) != 0 ||
+        stat(tmp, &gz_st) != 0)
+    {
+        WARN("Failed to compress '%s', put it uncompressed", src);
+        te_string_free(&cmd);
+        unlink(tmp);
+        return 0;
+    }
+    te_string_free(&cmd);
+
+    snprintf(dst_gz, sizeof(dst_gz), "%s.libts.gz", dst);
+    rc = rcf_ta_put_file(ta, 0, tmp, dst_gz);
+    unlink(tmp);
+    if (rc != 0)
+        return rc;
+
+    /*
+     * The file is decompressed next to the destination and moved into
+     * place with the source mode, so a failed decompression does not
+     * leave a truncated file and executables stay executable.
+     */
+    *done = TRUE;
+    rc = libts_shell_quote(&gz_q, dst_gz);
+    if (rc == 0)
+        rc = libts_shell_quote(&dst_q, dst);
+    if (rc == 0)
+    {
+        rc = libts_ta_shell(ta, NULL, "gzip -dc %s >%s.tmp && "
+                            "chmod %o %s.tmp && mv -f %s.tmp %s; "
+                            "rc=$?; rm -f %s %s.tmp; exit $rc",
+                            gz_q.ptr, gz_q.ptr,
+                            (unsigned int)(src_st.st_mode & 07777),
+                            gz_q.ptr, gz_q.ptr, dst_q.ptr,
+                            gz_q.ptr, gz_q.ptr);
+    }
+    te_string_free(&gz_q);
+    te_string_free(&dst_q);
+    if (rc != 0)
+        return rc;
+
+    RING("File '%s' put to %s:%s compressed: %llu -> %llu bytes "
+         "(ratio %.2f) in %.3f seconds", src, ta, dst,
+         (unsigned long long)src_st.st_size,
+         (unsigned long long)gz_st.st_size,
+         gz_st.st_size == 0 ? 0. :
+                              (double)src_st.st_size / gz_st.st_size,
+         (libts_monotonic_ms() - start) / 1000);
+
+    return 0;
+}
+
+/**
+ * Put file to a test agent compressed if SFC_ONLOAD_COPY_COMPRESS
+ * environment variable is set to @c TRUE or as is otherwise.
+ *
+ * @param ta        Test Agent name.
+ * @param src       Source file name on the engine.
+ * @param dst       Destination file name on the agent.
+ *
+ * @return Status code.
+ */
+static te_errno
+put_file(const char *ta, const char *src, const char *dst)
+{
+    te_bool     done = FALSE;
+    double      start;
+    te_errno    rc;
+
+    if (tapi_getenv_bool("SFC_ONLOAD_COPY_COMPRESS"))
+    {
+        rc = put_file_compressed(ta, src, dst, &done);
+        if (rc != 0 || done)
+            return rc;
+    }
+
+    start = libts_monotonic_ms();
+    rc = rcf_ta_put_file(ta, 0, src, dst);
+    if (rc == 0)
+    {
+        RING("File '%s' put to %s:%s in %.3f seconds", src, ta, dst,
+             (libts_monotonic_ms() - start) / 1000);
+    }
+
+    return rc;
+}
+
+/**
+ * Put file to a test agent unless it is already there or in the agent
+ * files cache. Files are identified by their content digest.
+ *
+ * @param ta        Test Agent name.
+ * @param src       Source file name on the engine.
+ * @param dst       Destination file name on the agent.
+ * @param done      Set to @c TRUE if there is nothing to put anymore.
+ *
+ * @return Status code.
+ */
+static te_errno
+put_file_cached(const char *ta, const char *src, const char *dst,
+                te_bool *done)
+{
+    const char *cache_dir = getenv("SFC_ONLOAD_COPY_CACHE_DIR");
+    te_string   dir_q = TE_STRING_INIT;
+    te_string   dst_q = TE_STRING_INIT;
+    copy_cache_stats stats;
+    char        digest[LIBTS_DIGEST_LEN + 1];
+    char        ta_digest[LIBTS_DIGEST_LEN + 1];
+    struct stat st;
+    int         status;
+    te_errno    rc;
+
+    *done = FALSE;
+
+    if (cache_dir == NULL || cache_dir[0] == '\0')
+        cache_dir = LIBTS_COPY_CACHE_DIR_DEF;
+
+    if (stat(src, &st) != 0 || engine_file_digest(src, digest) != 0)
+    {
+        WARN("Failed to get digest of '%s', transfer it as is", src);
+        return 0;
+    }
+
+    rc = ta_file_digest(ta, dst, ta_digest);
+    if (rc != 0)
+        return rc;
+
+    if (strcmp(digest, ta_digest) == 0)
+    {
+        stats = copy_cache_stats_update(TRUE, st.st_size);
+        RING("File '%s' is already on %s:%s, transfer skipped "
+             "(cache hits %u, misses %u, %llu bytes saved)",
+             src, ta, dst, stats.hits, stats.misses, stats.bytes_saved);
+        *done = TRUE;
+        return 0;
+    }
+
+    rc = libts_shell_quote(&dir_q, cache_dir);
+    if (rc == 0)
+        rc = libts_shell_quote(&dst_q, dst);
+    if (rc == 0)
+    {
+        rc = libts_ta_shell(ta, &status, "test -f %s/%s && cp -f %s/%s %s",
+                            dir_q.ptr, digest, dir_q.ptr, digest,
+                            dst_q.ptr);
+    }
+    if (rc != 0)
+        goto out;
+
+    if (status == 0)
+    {
+        stats = copy_cache_stats_update(TRUE, st.st_size);
+        RING("File '%s' is taken from %s:%s cache, transfer skipped "
+             "(cache hits %u, misses %u, %llu bytes saved)",
+             src, ta, cache_dir, stats.hits, stats.misses,
+             stats.bytes_saved);
+        *done = TRUE;
+        goto out;
+    }
+
+    rc = put_file(ta, src, dst);
+    if (rc != 0)
+        goto out;
+
+    stats = copy_cache_stats_update(FALSE, st.st_size);
+    RING("File '%s' is not cached on %s, put it "
+         "(cache hits %u, misses %u, %llu bytes saved)",
+         src, ta, stats.hits, stats.misses, stats.bytes_saved);
+    *done = TRUE;
+
+    /*
+     * Populate the cache via temporary file to avoid exposure of
+     * a partially written entry to concurrent users.
+     */
+    rc = libts_ta_shell(ta, &status,
+                        "mkdir -p %s && cp -f %s %s/%s.$$ && "
+                        "mv -f %s/%s.$$ %s/%s",
+                        dir_q.ptr, dst_q.ptr, dir_q.ptr, digest,
+                        dir_q.ptr, digest, dir_q.ptr, digest);
+    if (rc == 0 && status != 0)
+        WARN("Failed to add '%s' to %s:%s cache", dst, ta, cache_dir);
+    rc = 0;
+
+out:
+    te_string_free(&dir_q);
+    te_string_free(&dst_q);
+    return rc;
+}
+
+/* See description in lib-ts.h */
+te_errno
+libts_put_file_ta(const char *ta, const char *src, const char *dst)
+{
+    te_bool     done = FALSE;
+    te_errno    rc;
+
+    if (tapi_getenv_bool("SFC_ONLOAD_COPY_CACHE"))
+    {
+        rc = put_file_cached(ta, src, dst, &done);
+        if (rc != 0 || done)
+            return rc;
+    }
+
+    return put_file(ta, src, dst);
+}
 
 /* See description in lib-ts.h */
 te_errno
@@ -33,6 +684,7 @@ libts_fix_tas_path_env(void)
     char           *ta_name = NULL;
     unsigned int    i;
 
+    libts_timing_start("fix_tas_path_env");
     CHECK_RC(cfg_find_pattern_fmt(&nb_ta_handles, &ta_handles, "/agent:*"));
     for (i = 0; i < nb_ta_handles; i++)
     {
@@ -41,22 +693,18 @@ libts_fix_tas_path_env(void)
         free(ta_name);
     }
     free(ta_handles);
+    libts_timing_stop();
 }
 
 /* See description in lib-ts.h */
 void
 libts_set_zf_host_addr(void)
 {
-    te_string       zf_attr = TE_STRING_INIT_STATIC(RCF_MAX_PATH);
-    cfg_handle     *addresses = NULL;
-    char           *inst_name = NULL;
+    libts_addrs     addrs;
     const char     *if_name = NULL;
     const char     *ta = NULL;
-    unsigned int    addr_num;
     cfg_handle      handle = CFG_HANDLE_INVALID;
     te_errno        rc;
-    te_bool         ip4_found = FALSE;
-    unsigned int    i;
 
     if ((ta = getenv("TE_IUT_TA_NAME_NS")) == NULL)
         return;
@@ -68,38 +716,20 @@ libts_set_zf_host_addr(void)
     if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
         return;
 
-    CHECK_RC(cfg_get_instance(handle, NULL, &inst_name));
-    CHECK_RC(te_string_append(&zf_attr, "%s", inst_name));
-    free(inst_name);
-
-    CHECK_RC(cfg_find_pattern_fmt(&addr_num, &addresses,
-                                  "/agent:%s/interface:%s/net_addr:*",
-                                  ta, if_name));
-
-    for (i = 0; i < addr_num; i++)
-    {
-        CHECK_RC(cfg_get_inst_name(addresses[i], &inst_name));
-        /* Checking for version ip address. IPv4 is needed for ZF. */
-        if (strchr(inst_name, ':') == NULL)
-        {
-            ip4_found = TRUE;
-            break;
-        }
-
-        free(inst_name);
-    }
-
-    if (ip4_found == FALSE)
+    /* IPv4 address is needed for ZF. */
+    CHECK_RC(libts_addrs_get_first(ta, if_name, AF_INET, &addrs));
+    if (addrs.n_addrs == 0)
     {
         ERROR("Failed to find IPv4 address of %s", if_name);
+        libts_addrs_free(&addrs);
         return;
     }
 
-    CHECK_RC(te_string_append(&zf_attr, ";zfss_implicit_host=%s", inst_name));
-    CHECK_RC(cfg_set_instance(handle, CVT_STRING, zf_attr.ptr));
+    /* The key is replaced if it is set already */
+    CHECK_RC(libts_tune_set(ta, LIBTS_TUNE_ZF_ATTR, "zfss_implicit_host",
+                            addrs.addrs[0].str));
 
-    free(inst_name);
-    free(addresses);
+    libts_addrs_free(&addrs);
 }
 
 /* See description in lib-ts.h */
@@ -141,8 +771,7 @@ libts_send_enter2serial_console(const char *ta,
                                 const char *rpc_server_name,
                                 const char *console_name)
 {
-    rcf_rpc_server    *rpcs_serial;
-    tapi_serial_handle p_handle = NULL;
+    libts_serial_session *session;
     char *te_sc_write_disable = getenv("TE_SERIAL_CONSOLE_WRITE_DISABLE");
 
     if (te_sc_write_disable != NULL && te_sc_write_disable[0] != '\0')
@@ -153,26 +782,14 @@ libts_send_enter2serial_console(const char *ta,
     }
 
     /* It fails when Agt_D doesn't exist. */
-    if (rcf_rpc_server_create(ta, rpc_server_name,
-                              &rpcs_serial) != 0)
-    {
-        WARN("Failed to create RPC server on %s", ta);
-        return;
-    }
-    RPC_AWAIT_IUT_ERROR(rpcs_serial);
-    tapi_serial_open_rpcs(rpcs_serial, console_name,
-                          &p_handle);
-    if (p_handle != NULL && p_handle->sock > 0)
-    {
-        CHECK_RC(tapi_serial_force_rw(p_handle));
-        CHECK_RC(tapi_serial_send_enter(p_handle));
-        CHECK_RC(tapi_serial_spy(p_handle));
-    }
-    else
+    if (libts_serial_session_get(ta, rpc_server_name, console_name,
+                                 &session) != 0)
     {
         WARN("Failed to open console for %s", ta);
+        return;
     }
-    CHECK_RC(rcf_rpc_server_destroy(rpcs_serial));
+
+    CHECK_RC(libts_serial_send_enter(session));
 }
 
 /* See description in lib-ts.h */
@@ -208,7 +825,7 @@ libts_file_copy_ta(const char *ta, const char *src, const char *dst,
             else
                 return rc;
         }
-        rc = rcf_ta_put_file(ta, 0, src, dst);
+        rc = libts_put_file_ta(ta, src, dst);
         if (rc != 0)
         {
             ERROR("Failed to put file '%s' to %s:%s", src, ta, dst);
@@ -221,38 +838,199 @@ libts_file_copy_ta(const char *ta, const char *src, const char *dst,
     return rc;
 }
 
+/** Default number of concurrent socket libraries deployment workers */
+#define LIBTS_COPY_WORKERS_DEF 8
+
+/** Deployment of a socket library to a test agent */
+typedef struct socklib_job {
+    char       *ta;             /**< Test Agent name */
+    char       *socklib;        /**< Library file name on the engine */
+    char       *remote_file;    /**< Library file name on the agent */
+    cfg_handle  handle;         /**< /local:<ta>/socklib: instance */
+    te_bool     copied;         /**< Whether the library is put */
+    te_errno    rc;             /**< Deployment status */
+} socklib_job;
+
+/** Queue of socket libraries deployment jobs shared by workers */
+typedef struct socklib_queue {
+    socklib_job        *jobs;   /**< Jobs */
+    unsigned int        n_jobs; /**< Number of jobs */
+    unsigned int        next;   /**< Index of the first not started job */
+    pthread_mutex_t     lock;   /**< Lock protecting @p next */
+} socklib_queue;
+
+/**
+ * Put socket library to the agent and make it setuid and executable.
+ *
+ * @param job       Deployment job.
+ *
+ * @return Status code.
+ */
+static te_errno
+socklib_deploy(socklib_job *job)
+{
+    te_errno    rc;
+    int         rc2;
+
+    rc = libts_file_copy_ta(job->ta, job->socklib, job->remote_file, TRUE);
+    if (rc != 0)
+        return rc;
+    job->copied = TRUE;
+
+    rc = rcf_ta_call(job->ta, 0, "shell", &rc2, 3, TRUE,
+                     "chmod", "+s,a+rx", job->remote_file);
+    if (rc != 0)
+    {
+        ERROR("Failed to call 'shell' on %s: %r", job->ta, rc);
+        return rc;
+    }
+    if (rc2 != 0)
+    {
+        ERROR("Failed to execute 'chmod' on %s: %r", job->ta, rc2);
+        return rc2;
+    }
+
+    return 0;
+}
+
+/**
+ * Socket libraries deployment worker: take jobs from the queue until
+ * it is empty.
+ *
+ * @param arg       Jobs queue.
+ *
+ * @return @c NULL
+ */
+static void *
+socklib_worker(void *arg)
+{
+    socklib_queue  *queue = arg;
+    socklib_job    *job;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&queue->lock);
+        job = queue->next < queue->n_jobs ? &queue->jobs[queue->next++] :
+                                            NULL;
+        pthread_mutex_unlock(&queue->lock);
+
+        if (job == NULL)
+            break;
+
+        job->rc = socklib_deploy(job);
+    }
+
+    return NULL;
+}
+
+/**
+ * Run socket libraries deployment jobs concurrently using a bounded
+ * number of workers (SFC_ONLOAD_COPY_WORKERS environment variable).
+ *
+ * @param jobs      Jobs.
+ * @param n_jobs    Number of jobs.
+ */
+static void
+socklib_deploy_all(socklib_job *jobs, unsigned int n_jobs)
+{
+    socklib_queue   queue = { .jobs = jobs, .n_jobs = n_jobs, .next = 0 };
+    pthread_t      *threads;
+    unsigned int    n_workers;
+    unsigned int    n_started;
+
+    n_workers = libts_getenv_uint("SFC_ONLOAD_COPY_WORKERS", 1, UINT_MAX,
+                                  LIBTS_COPY_WORKERS_DEF);
+    if (n_workers > n_jobs)
+        n_workers = n_jobs;
+
+    pthread_mutex_init(&queue.lock, NULL);
+
+    threads = calloc(n_workers, sizeof(*threads));
+    for (n_started = 0; threads != NULL && n_started < n_workers;
+         n_started++)
+    {
+        if (pthread_create(&threads[n_started], NULL, socklib_worker,
+                           &queue) != 0)
+        {
+            WARN("Failed to start socket libraries deployment worker");
+            break;
+        }
+    }
+
+    /* Help workers or do the whole job if none of them is started */
+    socklib_worker(&queue);
+
+    while (n_started > 0)
+        pthread_join(threads[--n_started], NULL);
+
+    free(threads);
+    pthread_mutex_destroy(&queue.lock);
+}
+
+/**
+ * Release socket libraries deployment jobs.
+ *
+ * @param jobs      Jobs.
+ * @param n_jobs    Number of jobs.
+ */
+static void
+socklib_jobs_free(socklib_job *jobs, unsigned int n_jobs)
+{
+    unsigned int i;
+
+    for (i = 0; i < n_jobs; i++)
+    {
+        free(jobs[i].ta);
+        free(jobs[i].socklib);
+        free(jobs[i].remote_file);
+    }
+    free(jobs);
+}
+
 /* See description in lib-ts.h */
 te_errno
 libts_copy_socklibs(void)
 {
+    const char * const libdir_def = "/usr/lib";
+    const char * const remote_libname = "libte-iut.so";
+
     te_errno        rc;
     unsigned int    n_socklibs;
     cfg_handle     *socklibs = NULL;
+    socklib_job    *jobs;
+    socklib_job    *job;
+    unsigned int    n_jobs = 0;
     unsigned int    i;
     cfg_val_type    val_type;
     cfg_oid        *oid = NULL;
+    char           *socklib;
+    char           *libdir;
+    te_string       remote_file = TE_STRING_INIT;
 
+    libts_timing_start("copy_socklibs");
     rc = cfg_find_pattern("/local:*/socklib:", &n_socklibs, &socklibs);
     if (rc != 0)
     {
         TEST_FAIL("cfg_find_pattern(/local:*/socklib:) failed: %r", rc);
     }
-    for (i = 0; i < n_socklibs; ++i)
-    {
-        const char * const libdir_def = "/usr/lib";
-        const char * const remote_libname = "libte-iut.so";
 
-        char   *socklib;
-        char   *libdir;
-        char   *remote_file;
+    jobs = calloc(n_socklibs + 1, sizeof(*jobs));
+    if (jobs == NULL)
+    {
+        free(socklibs);
+        TEST_FAIL("Memory allocation failure");
+    }
 
+    for (i = 0; i < n_socklibs; ++i)
+    {
         val_type = CVT_STRING;
         rc = cfg_get_instance(socklibs[i], &val_type, &socklib);
         if (rc != 0)
         {
-            free(socklibs);
-            TEST_FAIL("cfg_get_instance() failed: %r", rc);
+            ERROR("cfg_get_instance() failed: %r", rc);
+            break;
         }
+
         if (strlen(socklib) == 0)
         {
             /* Just ignore empty values */
@@ -260,12 +1038,16 @@ libts_copy_socklibs(void)
             continue;
         }
 
+        job = &jobs[n_jobs];
+        job->socklib = socklib;
+        job->handle = socklibs[i];
+        n_jobs++;
+
         rc = cfg_get_oid(socklibs[i], &oid);
         if (rc != 0)
         {
-            free(socklib);
-            free(socklibs);
-            TEST_FAIL("cfg_get_oid() failed: %r", rc);
+            ERROR("cfg_get_oid() failed: %r", rc);
+            break;
         }
 
         val_type = CVT_STRING;
@@ -278,81 +1060,74 @@ libts_copy_socklibs(void)
         }
         else if (rc != 0)
         {
+            ERROR("%u: cfg_get_instance_fmt() failed: %r", __LINE__, rc);
             cfg_free_oid(oid);
-            free(socklib);
-            free(socklibs);
-            TEST_FAIL("%u: cfg_get_instance_fmt() failed", __LINE__);
+            break;
         }
 
         /* Prepare name of the remote file to put */
-        remote_file = malloc(strlen(libdir) + 1 /* '/' */ +
-                             strlen(remote_libname) + 1 /* '\0' */);
-        if (remote_file == NULL)
+        te_string_reset(&remote_file);
+        rc = te_string_append(&remote_file, "%s/%s", libdir,
+                              remote_libname);
+        if (libdir != libdir_def)
+            free(libdir);
+
+        job->ta = strdup(CFG_OID_GET_INST_NAME(oid, 1));
+        job->remote_file = rc == 0 ? strdup(remote_file.ptr) : NULL;
+        cfg_free_oid(oid);
+        if (rc != 0 || job->ta == NULL || job->remote_file == NULL)
         {
-            if (libdir != libdir_def)
-                free(libdir);
-            cfg_free_oid(oid);
-            free(socklib);
-            free(socklibs);
-            TEST_FAIL("Memory allocation failure");
+            ERROR("Memory allocation failure");
+            rc = TE_RC(TE_TAPI, TE_ENOMEM);
+            break;
         }
+    }
+    te_string_free(&remote_file);
+    free(socklibs);
 
-        strcpy(remote_file, libdir);
-        if (libdir != libdir_def)
-            free(libdir);
-        strcat(remote_file, "/");
-        strcat(remote_file, remote_libname);
+    if (rc != 0)
+    {
+        socklib_jobs_free(jobs, n_jobs);
+        TEST_FAIL("Failed to get socket libraries to deploy: %r", rc);
+    }
 
-        rc = libts_file_copy_ta(CFG_OID_GET_INST_NAME(oid, 1), socklib,
-                                remote_file, TRUE);
-        if (rc != 0)
+    socklib_deploy_all(jobs, n_jobs);
+
+    /*
+     * Report the result in the order of the configuration tree walk
+     * and stop on the first failure as the sequential deployment does.
+     * The instance is updated if the library is put, even if it is not
+     * made executable, as the sequential deployment did it before chmod.
+     */
+    for (i = 0; i < n_jobs; i++)
+    {
+        job = &jobs[i];
+        if (!job->copied)
         {
-            free(remote_file);
-            cfg_free_oid(oid);
-            free(socklib);
-            free(socklibs);
-            goto cleanup;
+            rc = job->rc;
+            ERROR("Failed to deploy '%s' to %s:%s", job->socklib,
+                  job->ta, job->remote_file);
+            break;
         }
 
-        free(socklib);
-        rc = cfg_set_instance(socklibs[i], val_type, remote_file);
+        rc = cfg_set_instance(job->handle, CVT_STRING, job->remote_file);
         if (rc != 0)
         {
-            free(remote_file);
-            cfg_free_oid(oid);
-            free(socklibs);
+            socklib_jobs_free(jobs, n_jobs);
             TEST_FAIL("cfg_set_instance() failed: %r", rc);
         }
 
+        rc = job->rc;
+        if (rc != 0)
         {
-            int rc2;
-
-            rc = rcf_ta_call(CFG_OID_GET_INST_NAME(oid, 1), 0, "shell",
-                             &rc2, 3, TRUE, "chmod", "+s,a+rx", remote_file);
-            if (rc != 0)
-            {
-                ERROR("Failed to call 'shell' on %s: %r",
-                      CFG_OID_GET_INST_NAME(oid, 1), rc);
-                free(remote_file);
-                cfg_free_oid(oid);
-                free(socklibs);
-                goto cleanup;
-            }
-            if ((rc = rc2) != 0)
-            {
-                ERROR("Failed to execute 'chmod' on %s: %r",
-                      CFG_OID_GET_INST_NAME(oid, 1), rc2);
-                free(remote_file);
-                cfg_free_oid(oid);
-                free(socklibs);
-                goto cleanup;
-            }
+            ERROR("Failed to deploy '%s' to %s:%s", job->socklib,
+                  job->ta, job->remote_file);
+            break;
         }
-        free(remote_file);
-        cfg_free_oid(oid);
     }
-    free(socklibs);
 
-cleanup:
+    socklib_jobs_free(jobs, n_jobs);
+    libts_timing_stop();
+
     return rc;
 }
@@ -26,6 +26,7 @@
 #if HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#include <limits.h>
 
 #include "te_defs.h"
 #include "te_errno.h"
@@ -38,6 +39,103 @@
 #include "tapi_serial.h"
 #include "tapi_file.h"
 
+/**
+ * Get memoized value of a fact derived from the environment and
+ * configuration (e.g. which agent controls SFC interfaces), so it is
+ * not queried from configurator every time.
+ *
+ * @note Memoized values are kept for the lifetime of the test process
+ *       and are dropped by libts_memo_invalidate() when the topology
+ *       changes (see libts_setup_namespace() and libts_cleanup_netns()).
+ *
+ * @param key       Key of the value.
+ * @param value     Where to put the value (from the heap).
+ *
+ * @return Status code (@c TE_ENOENT if there is no value).
+ */
+extern te_errno libts_memo_get(const char *key, char **value);
+
+/**
+ * Memoize value of a fact derived from the environment and
+ * configuration.
+ *
+ * @param key       Key of the value.
+ * @param value     Value.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_memo_set(const char *key, const char *value);
+
+/**
+ * Drop all memoized values.
+ */
+extern void libts_memo_invalidate(void);
+
+/**
+ * Get current time of the monotonic clock in milliseconds.
+ *
+ * @return Time in milliseconds.
+ */
+extern double libts_monotonic_ms(void);
+
+/**
+ * Get unsigned integer value of an environment variable. Invalid and
+ * out of range values are reported and replaced with the default one.
+ *
+ * @param name      Variable name.
+ * @param min       Minimum allowed value.
+ * @param max       Maximum allowed value.
+ * @param def       Default value (used if the variable is not set or
+ *                  empty).
+ *
+ * @return Value.
+ */
+extern unsigned int libts_getenv_uint(const char *name, unsigned int min,
+                                      unsigned int max, unsigned int def);
+
+/**
+ * Append a string quoted as a single shell word, i.e. in single quotes
+ * with single quotes in it replaced with '\''.
+ *
+ * @param str       Where to append.
+ * @param arg       String to quote.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_shell_quote(te_string *str, const char *arg);
+
+/**
+ * Run shell command on a Test Agent.
+ *
+ * @note Paths and other strings which are put into the command should be
+ *       quoted with libts_shell_quote().
+ *
+ * @param ta        Test Agent name.
+ * @param status    Where to put exit status of the command or @c NULL
+ *                  if non-zero exit status should be treated as error.
+ * @param fmt       Format string of the command.
+ * @param ...       Format string arguments.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_ta_shell(const char *ta, int *status,
+                               const char *fmt, ...)
+                               __attribute__((format(printf, 3, 4)));
+
+/**
+ * Run shell command on a Test Agent and get its standard output.
+ *
+ * @param ta        Test Agent name.
+ * @param out       Where to put the output (from the heap).
+ * @param fmt       Format string of the command.
+ * @param ...       Format string arguments.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_ta_shell_get(const char *ta, char **out,
+                                   const char *fmt, ...)
+                                   __attribute__((format(printf, 3, 4)));
+
 /**
  * Update PATH variable for Test Agent.
  *
@@ -72,6 +170,11 @@ extern void libts_init_console_loglevel(void);
 /**
  * Set to RW mode conserver, send enter and return back to RO mode.
  *
+ * @note The console is written via a serial console session (see
+ *       lib-ts_serial.h): the RPC server @p rpc_server_name is created
+ *       on the first call and is not destroyed after it, it lives until
+ *       the test process exit and captures the console output meanwhile.
+ *
  * @param ta              Test Agent name
  * @param rpc_server_name RPC server name
  * @param console_name    Console name
@@ -84,6 +187,10 @@ extern void libts_send_enter2serial_console(const char *ta,
  * Copy Socket API libraries specified in /local/socklib instances
  * to corresponding test agent.
  *
+ * @note Libraries are deployed to all agents concurrently, the number
+ *       of concurrent transfers is limited by SFC_ONLOAD_COPY_WORKERS
+ *       environment variable (@c 8 by default).
+ *
  * @return Status code.
  */
 extern te_errno libts_copy_socklibs(void);
@@ -102,6 +209,29 @@ extern te_errno libts_copy_socklibs(void);
 extern int libts_file_copy_ta(const char *ta, const char *src,
                               const char *dst, te_bool non_exist_f);
 
+/**
+ * Put file from engine to agent.
+ *
+ * @note If SFC_ONLOAD_COPY_CACHE environment variable is set to @c TRUE,
+ *       the file is identified by its MD5 digest and is not transferred
+ *       if the destination or the agent files cache (located in
+ *       SFC_ONLOAD_COPY_CACHE_DIR, @c /var/tmp/libts_copy_cache by
+ *       default) already has the same content.
+ *
+ * @note If SFC_ONLOAD_COPY_COMPRESS environment variable is set to
+ *       @c TRUE, the file is transferred compressed with gzip and
+ *       decompressed on the agent. The file is transferred as is if
+ *       the agent has no gzip.
+ *
+ * @param ta            Test Agent name
+ * @param src           Source file name on the engine
+ * @param dst           Destination file name on the agent
+ *
+ * @return Status code.
+ */
+extern te_errno libts_put_file_ta(const char *ta, const char *src,
+                                  const char *dst);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
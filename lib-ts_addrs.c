@@ -0,0 +1,553 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Network addresses snapshot API
+ *
+ * Implementation of network addresses snapshot.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Addrs"
+
+#include <pthread.h>
+#include <sys/queue.h>
+
+#include "lib-ts.h"
+#include "lib-ts_addrs.h"
+
+/** Kept snapshot */
+static libts_addrs addrs_cache;
+
+/** Whether @p addrs_cache is taken */
+static te_bool addrs_cached = FALSE;
+
+/** Lock protecting @p addrs_cache */
+static pthread_mutex_t addrs_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Compare addresses by agent, interface and address family.
+ *
+ * @param a         The first address.
+ * @param b         The second address.
+ *
+ * @return Negative, zero or positive value as strcmp() does.
+ */
+static int
+addr_cmp(const libts_addr *a, const libts_addr *b)
+{
+    int rc;
+
+    rc = strcmp(a->ta, b->ta);
+    if (rc == 0)
+        rc = strcmp(a->ifname, b->ifname);
+    if (rc == 0)
+        rc = (int)a->addr.ss_family - (int)b->addr.ss_family;
+
+    return rc;
+}
+
+/**
+ * Compare an address with a lookup key. Key fields which are not
+ * specified match any value.
+ *
+ * @param a         Address.
+ * @param ta        Test Agent name.
+ * @param ifname    Interface name or @c NULL.
+ * @param af        Address family or @c AF_UNSPEC.
+ *
+ * @return Negative, zero or positive value as strcmp() does.
+ */
+static int
+addr_key_cmp(const libts_addr *a, const char *ta, const char *ifname,
+             int af)
+{
+    int rc;
+
+    rc = strcmp(a->ta, ta);
+    if (rc != 0 || ifname == NULL)
+        return rc;
+
+    rc = strcmp(a->ifname, ifname);
+    if (rc != 0 || af == AF_UNSPEC)
+        return rc;
+
+    return (int)a->addr.ss_family - af;
+}
+
+/**
+ * Check whether an address belongs to a subnet.
+ *
+ * @param addr      Address.
+ * @param net       Subnet address.
+ * @param prefix    Subnet prefix length.
+ *
+ * @return @c TRUE if the address belongs to the subnet.
+ */
+static te_bool
+addr_in_subnet(const struct sockaddr *addr, const struct sockaddr *net,
+               unsigned int prefix)
+{
+    const uint8_t  *a;
+    const uint8_t  *n;
+    unsigned int    bytes;
+    unsigned int    bits;
+
+    if (addr->sa_family != net->sa_family)
+        return FALSE;
+
+    if (prefix > te_netaddr_get_size(net->sa_family) * 8)
+        return FALSE;
+
+    a = te_sockaddr_get_netaddr(addr);
+    n = te_sockaddr_get_netaddr(net);
+    bytes = prefix / 8;
+    bits = prefix % 8;
+
+    if (memcmp(a, n, bytes) != 0)
+        return FALSE;
+
+    return bits == 0 ||
+           ((a[bytes] ^ n[bytes]) & (0xff << (8 - bits)) & 0xff) == 0;
+}
+
+/**
+ * Release addresses of a snapshot.
+ *
+ * @param addrs     Snapshot.
+ */
+static void
+addrs_clear(libts_addrs *addrs)
+{
+    unsigned int i;
+
+    for (i = 0; i < addrs->n_addrs; i++)
+    {
+        free(addrs->addrs[i].ta);
+        free(addrs->addrs[i].ifname);
+        free(addrs->addrs[i].str);
+    }
+    free(addrs->addrs);
+    addrs->addrs = NULL;
+    addrs->n_addrs = 0;
+}
+
+/**
+ * Copy an address.
+ *
+ * @param dst       Where to copy.
+ * @param src       Address to copy.
+ *
+ * @return Status code.
+ */
+static te_errno
+addr_copy(libts_addr *dst, const libts_addr *src)
+{
+    *dst = *src;
+    dst->ta = strdup(src->ta);
+    dst->ifname = strdup(src->ifname);
+    dst->str = strdup(src->str);
+    if (dst->ta == NULL || dst->ifname == NULL || dst->str == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+
+    return 0;
+}
+
+/**
+ * Fill an address by its instance name in configurator.
+ *
+ * @param addr      Address to fill.
+ * @param ta        Test Agent name.
+ * @param ifname    Interface name.
+ * @param str       Address instance name.
+ *
+ * @return Status code.
+ */
+static te_errno
+addr_fill(libts_addr *addr, const char *ta, const char *ifname,
+          const char *str)
+{
+    te_errno rc;
+
+    memset(addr, 0, sizeof(*addr));
+    addr->prefix = -1;
+
+    rc = te_sockaddr_str2h(str, SA(&addr->addr));
+    if (rc != 0)
+        return rc;
+
+    addr->ta = strdup(ta);
+    addr->ifname = strdup(ifname);
+    addr->str = strdup(str);
+    if (addr->ta == NULL || addr->ifname == NULL || addr->str == NULL)
+    {
+        free(addr->ta);
+        free(addr->ifname);
+        free(addr->str);
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+    }
+
+    return 0;
+}
+
+/**
+ * Take network addresses from configurator and put them to a snapshot.
+ * Only the instance names are requested, i.e. one configurator request
+ * is made per address (see libts_addrs_match_prefix() about prefixes).
+ * Addresses which cannot be parsed are skipped.
+ *
+ * @param addrs     Snapshot.
+ * @param ta        Test Agent name or @c NULL for all agents.
+ * @param ifname    Interface name or @c NULL for all interfaces
+ *                  (should be @c NULL if @p ta is @c NULL).
+ * @param af        Address family to stop at the first address of or
+ *                  @c AF_UNSPEC to take all addresses.
+ *
+ * @return Status code.
+ */
+static te_errno
+addrs_take(libts_addrs *addrs, const char *ta, const char *ifname, int af)
+{
+    cfg_handle     *handles = NULL;
+    unsigned int    n_handles = 0;
+    cfg_oid        *oid = NULL;
+    char           *str = NULL;
+    libts_addr      tmp;
+    unsigned int    i;
+    unsigned int    j;
+    te_errno        rc;
+
+    rc = cfg_find_pattern_fmt(&n_handles, &handles,
+                              "/agent:%s/interface:%s/net_addr:*",
+                              ta == NULL ? "*" : ta,
+                              ifname == NULL ? "*" : ifname);
+    if (rc != 0)
+    {
+        ERROR("Failed to find network addresses: %r", rc);
+        return rc;
+    }
+
+    addrs->addrs = calloc(n_handles + 1, sizeof(*addrs->addrs));
+    if (addrs->addrs == NULL)
+    {
+        free(handles);
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+    }
+
+    for (i = 0; i < n_handles; i++)
+    {
+        libts_addr *addr = &addrs->addrs[addrs->n_addrs];
+
+        /*
+         * Agent and interface are known if a single interface is
+         * asked for, otherwise they are taken from the OID at once
+         * with the address.
+         */
+        if (ifname != NULL)
+        {
+            rc = cfg_get_inst_name(handles[i], &str);
+            if (rc != 0)
+                break;
+            rc = addr_fill(addr, ta, ifname, str);
+        }
+        else
+        {
+            rc = cfg_get_oid(handles[i], &oid);
+            if (rc != 0)
+                break;
+            str = strdup(CFG_OID_GET_INST_NAME(oid, 3));
+            if (str == NULL)
+                rc = TE_RC(TE_TAPI, TE_ENOMEM);
+            else
+                rc = addr_fill(addr, CFG_OID_GET_INST_NAME(oid, 1),
+                               CFG_OID_GET_INST_NAME(oid, 2), str);
+            cfg_free_oid(oid);
+        }
+
+        if (rc != 0 && TE_RC_GET_ERROR(rc) != TE_ENOMEM)
+        {
+            WARN("Network address '%s' is skipped: %r", str, rc);
+            free(str);
+            str = NULL;
+            rc = 0;
+            continue;
+        }
+        free(str);
+        str = NULL;
+        if (rc != 0)
+            break;
+
+        addrs->n_addrs++;
+        if (af != AF_UNSPEC && addr->addr.ss_family == af)
+            break;
+    }
+    free(handles);
+
+    if (rc != 0)
+    {
+        addrs_clear(addrs);
+        return rc;
+    }
+
+    /*
+     * Insertion sort keeps the configurator order of addresses of
+     * the same interface and family, there are not many addresses.
+     */
+    for (i = 1; i < addrs->n_addrs; i++)
+    {
+        tmp = addrs->addrs[i];
+        for (j = i; j > 0 && addr_cmp(&addrs->addrs[j - 1], &tmp) > 0; j--)
+            addrs->addrs[j] = addrs->addrs[j - 1];
+        addrs->addrs[j] = tmp;
+    }
+
+    return 0;
+}
+
+/**
+ * Copy addresses to a new snapshot.
+ *
+ * @param addrs     Where to put the snapshot.
+ * @param first     The first address to copy.
+ * @param n         Number of addresses to copy.
+ *
+ * @return Status code.
+ */
+static te_errno
+addrs_copy(libts_addrs *addrs, const libts_addr *first, unsigned int n)
+{
+    unsigned int    i;
+    te_errno        rc = 0;
+
+    addrs->addrs = calloc(n + 1, sizeof(*addrs->addrs));
+    if (addrs->addrs == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+
+    for (i = 0; rc == 0 && i < n; i++)
+    {
+        rc = addr_copy(&addrs->addrs[i], &first[i]);
+        addrs->n_addrs++;
+    }
+
+    if (rc != 0)
+        addrs_clear(addrs);
+
+    return rc;
+}
+
+/* See description in lib-ts_addrs.h */
+te_errno
+libts_addrs_get(libts_addrs *addrs)
+{
+    te_errno rc = 0;
+
+    memset(addrs, 0, sizeof(*addrs));
+
+    pthread_mutex_lock(&addrs_lock);
+    if (!addrs_cached)
+    {
+        addrs_clear(&addrs_cache);
+        rc = addrs_take(&addrs_cache, NULL, NULL, AF_UNSPEC);
+        addrs_cached = (rc == 0);
+        if (rc == 0)
+        {
+            RING("Network addresses snapshot is taken: %u addresses",
+                 addrs_cache.n_addrs);
+        }
+    }
+
+    if (rc == 0)
+        rc = addrs_copy(addrs, addrs_cache.addrs, addrs_cache.n_addrs);
+    pthread_mutex_unlock(&addrs_lock);
+
+    return rc;
+}
+
+/* See description in lib-ts_addrs.h */
+te_errno
+libts_addrs_get_first(const char *ta, const char *ifname, int af,
+                      libts_addrs *addrs)
+{
+    libts_addrs         taken = { NULL, 0 };
+    const libts_addr   *addr;
+    te_errno            rc = 0;
+
+    memset(addrs, 0, sizeof(*addrs));
+
+    pthread_mutex_lock(&addrs_lock);
+    if (addrs_cached)
+    {
+        addr = libts_addrs_find(&addrs_cache, ta, ifname, af, NULL);
+        rc = addrs_copy(addrs, addr, addr == NULL ? 0 : 1);
+        pthread_mutex_unlock(&addrs_lock);
+        return rc;
+    }
+    pthread_mutex_unlock(&addrs_lock);
+
+    /* Addresses of other families may precede the found one */
+    rc = addrs_take(&taken, ta, ifname, af);
+    if (rc != 0)
+        return rc;
+
+    addr = libts_addrs_find(&taken, ta, ifname, af, NULL);
+    rc = addrs_copy(addrs, addr, addr == NULL ? 0 : 1);
+    addrs_clear(&taken);
+
+    return rc;
+}
+
+/* See description in lib-ts_addrs.h */
+void
+libts_addrs_free(libts_addrs *addrs)
+{
+    addrs_clear(addrs);
+}
+
+/* See description in lib-ts_addrs.h */
+void
+libts_addrs_invalidate(void)
+{
+    pthread_mutex_lock(&addrs_lock);
+    addrs_clear(&addrs_cache);
+    addrs_cached = FALSE;
+    pthread_mutex_unlock(&addrs_lock);
+}
+
+/* See description in lib-ts_addrs.h */
+const libts_addr *
+libts_addrs_find(const libts_addrs *addrs, const char *ta,
+                 const char *ifname, int af, unsigned int *n)
+{
+    unsigned int lo = 0;
+    unsigned int hi = addrs->n_addrs;
+    unsigned int mid;
+    unsigned int first;
+    unsigned int i;
+    unsigned int count = 0;
+
+    /* Lower bound of the range matching the key */
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (addr_key_cmp(&addrs->addrs[mid], ta, ifname, af) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    first = lo;
+
+    /* Upper bound of the range matching the key */
+    hi = addrs->n_addrs;
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (addr_key_cmp(&addrs->addrs[mid], ta, ifname, af) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    /*
+     * The family is not a part of the key if the interface is not
+     * specified, addresses of the family are not adjacent then, so
+     * only the first one is returned.
+     */
+    if (ifname == NULL && af != AF_UNSPEC)
+    {
+        for (i = first; i < lo; i++)
+        {
+            if (addrs->addrs[i].addr.ss_family == af)
+                break;
+        }
+        first = i;
+        count = i < lo ? 1 : 0;
+    }
+    else
+    {
+        count = lo - first;
+    }
+
+    if (n != NULL)
+        *n = count;
+
+    return count == 0 ? NULL : &addrs->addrs[first];
+}
+
+/* See description in lib-ts_addrs.h */
+const libts_addr *
+libts_addrs_find_subnet(const libts_addrs *addrs, const char *ta,
+                        const char *ifname, const struct sockaddr *net,
+                        unsigned int prefix)
+{
+    const libts_addr   *first;
+    unsigned int        n;
+    unsigned int        i;
+
+    first = libts_addrs_find(addrs, ta, ifname, AF_UNSPEC, &n);
+    for (i = 0; i < n; i++)
+    {
+        if (addr_in_subnet(SA(&first[i].addr), net, prefix))
+            return &first[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * Take prefix length of an address from configurator if it is not
+ * taken yet.
+ *
+ * @param addr      Address.
+ *
+ * @return Status code.
+ */
+static te_errno
+addr_prefix_take(libts_addr *addr)
+{
+    int32_t     prefix;
+    te_errno    rc;
+
+    if (addr->prefix >= 0)
+        return 0;
+
+    rc = cfg_get_int32(&prefix, "/agent:%s/interface:%s/net_addr:%s",
+                       addr->ta, addr->ifname, addr->str);
+    if (rc != 0)
+        return rc;
+
+    addr->prefix = prefix;
+    return 0;
+}
+
+/* See description in lib-ts_addrs.h */
+const libts_addr *
+libts_addrs_match_prefix(libts_addrs *addrs, const char *ta,
+                         const struct sockaddr *addr)
+{
+    libts_addr     *first;
+    libts_addr     *best = NULL;
+    unsigned int    n;
+    unsigned int    i;
+    te_errno        rc;
+
+    first = (libts_addr *)libts_addrs_find(addrs, ta, NULL, AF_UNSPEC, &n);
+    for (i = 0; i < n; i++)
+    {
+        if (first[i].addr.ss_family != addr->sa_family)
+            continue;
+
+        rc = addr_prefix_take(&first[i]);
+        if (rc != 0)
+        {
+            WARN("Failed to get prefix of %s on %s:%s, it is skipped: %r",
+                 first[i].str, first[i].ta, first[i].ifname, rc);
+            continue;
+        }
+
+        if (addr_in_subnet(addr, SA(&first[i].addr), first[i].prefix) &&
+            (best == NULL || first[i].prefix > best->prefix))
+            best = &first[i];
+    }
+
+    return best;
+}
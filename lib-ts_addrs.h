@@ -0,0 +1,140 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Network addresses snapshot API
+ *
+ * Snapshot of network addresses of all agents interfaces (net_addr
+ * instances in configurator) indexed by agent, interface and address
+ * family, so selecting an address of an interface does not require
+ * configurator requests.
+ *
+ * The snapshot is taken from configurator on the first request and is
+ * kept until libts_memo_invalidate() is called, i.e. until the topology
+ * is changed by the library. Only names of the addresses are taken, i.e.
+ * one configurator request is made per address; prefix lengths are taken
+ * only when they are needed (see libts_addrs_match_prefix()).
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_ADDRS_H__
+#define __ONLOAD_LIB_TS_ADDRS_H__
+
+#include <sys/socket.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+
+/** Network address of an interface */
+typedef struct libts_addr {
+    char                    *ta;        /**< Test Agent name */
+    char                    *ifname;    /**< Interface name */
+    char                    *str;       /**< Address as it is named in
+                                             configurator */
+    struct sockaddr_storage  addr;      /**< Address */
+    int                      prefix;    /**< Prefix length or @c -1 if
+                                             it is not taken yet */
+} libts_addr;
+
+/** Snapshot of network addresses sorted by agent, interface and family */
+typedef struct libts_addrs {
+    libts_addr     *addrs;      /**< Addresses */
+    unsigned int    n_addrs;    /**< Number of addresses */
+} libts_addrs;
+
+/**
+ * Get a copy of the snapshot of network addresses of all agents.
+ * The snapshot is taken from configurator if there is no one yet.
+ *
+ * @param addrs     Where to put the snapshot (should be released with
+ *                  libts_addrs_free()).
+ *
+ * @return Status code.
+ */
+extern te_errno libts_addrs_get(libts_addrs *addrs);
+
+/**
+ * Get the first address of an interface of the given family. If the
+ * snapshot is kept, the address is found in it, otherwise addresses of
+ * the interface are taken from configurator one by one until the address
+ * is found and are not kept.
+ *
+ * @param ta        Test Agent name.
+ * @param ifname    Interface name.
+ * @param af        Address family.
+ * @param addrs     Where to put the found address, there is no address
+ *                  in it if the interface has no address of the family
+ *                  (should be released with libts_addrs_free()).
+ *
+ * @return Status code.
+ */
+extern te_errno libts_addrs_get_first(const char *ta, const char *ifname,
+                                      int af, libts_addrs *addrs);
+
+/**
+ * Release a snapshot of network addresses.
+ *
+ * @param addrs     Snapshot.
+ */
+extern void libts_addrs_free(libts_addrs *addrs);
+
+/**
+ * Drop the kept snapshot, so the next libts_addrs_get() takes a new one.
+ */
+extern void libts_addrs_invalidate(void);
+
+/**
+ * Find addresses of an agent.
+ *
+ * @param addrs     Snapshot.
+ * @param ta        Test Agent name.
+ * @param ifname    Interface name or @c NULL for any interface.
+ * @param af        Address family or @c AF_UNSPEC for any family.
+ * @param n         Where to put the number of found addresses
+ *                  (may be @c NULL).
+ *
+ * @return The first found address (others follow it) or @c NULL.
+ *         If @p ifname is @c NULL and @p af is not @c AF_UNSPEC, only
+ *         the first address is found.
+ */
+extern const libts_addr *libts_addrs_find(const libts_addrs *addrs,
+                                          const char *ta,
+                                          const char *ifname, int af,
+                                          unsigned int *n);
+
+/**
+ * Find address of an agent from a subnet.
+ *
+ * @param addrs     Snapshot.
+ * @param ta        Test Agent name.
+ * @param ifname    Interface name or @c NULL for any interface.
+ * @param net       Subnet address.
+ * @param prefix    Subnet prefix length.
+ *
+ * @return The first found address or @c NULL.
+ */
+extern const libts_addr *libts_addrs_find_subnet(const libts_addrs *addrs,
+                                                 const char *ta,
+                                                 const char *ifname,
+                                                 const struct sockaddr *net,
+                                                 unsigned int prefix);
+
+/**
+ * Find address of an agent with the longest prefix whose subnet
+ * contains the given address, i.e. the address of the interface which
+ * is used to reach @p addr directly. Prefix lengths of addresses of the
+ * agent of the same family are taken from configurator if they are not
+ * taken yet; addresses whose prefix cannot be taken are skipped.
+ *
+ * @param addrs     Snapshot.
+ * @param ta        Test Agent name.
+ * @param addr      Address to match.
+ *
+ * @return The found address or @c NULL.
+ */
+extern const libts_addr *libts_addrs_match_prefix(
+                                            libts_addrs *addrs,
+                                            const char *ta,
+                                            const struct sockaddr *addr);
+
+#endif /* !__ONLOAD_LIB_TS_ADDRS_H__ */
@@ -0,0 +1,347 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Network addresses snapshot API unit test
+ *
+ * Checks of the snapshot index (order, lookups by agent, interface and
+ * family, subnets and prefixes) and of the number of configurator
+ * requests. Configurator is faked with a table of addresses.
+ *
+ * @author agent <agent@local>
+ */
+
+#include "lib-ts_addrs.c"
+#include "lib-ts_unit.h"
+
+DEFINE_LGR_ENTITY("libts_addrs_test");
+
+/** Fake configurator tree of network addresses */
+static const struct {
+    const char *ta;         /**< Test Agent name */
+    const char *ifname;     /**< Interface name */
+    const char *addr;       /**< Address instance name */
+    int         prefix;     /**< Prefix length or @c -1 if it cannot be
+                                 got */
+} fake_cfg[] = {
+    { "Agt_B", "eth1", "fe80::1", 64 },
+    { "Agt_A", "eth1", "10.0.1.2", 24 },
+    { "Agt_A", "eth0", "192.168.0.2", 16 },
+    { "Agt_A", "eth0", "fe80::2", 64 },
+    { "Agt_A", "eth0", "192.168.1.2", 24 },
+    { "Agt_A", "eth1", "bad-address", 0 },
+    { "Agt_A", "eth1", "10.0.0.2", -1 },
+};
+
+/** Number of configurator requests per address */
+static unsigned int fake_requests;
+
+/** Number of prefix requests */
+static unsigned int fake_prefix_requests;
+
+/**
+ * Check whether an instance name matches a pattern instance name.
+ *
+ * @param pattern   Pattern instance name or @c "*".
+ * @param name      Instance name.
+ *
+ * @return @c TRUE if it matches.
+ */
+static te_bool
+fake_match(const char *pattern, const char *name)
+{
+    return strcmp(pattern, "*") == 0 || strcmp(pattern, name) == 0;
+}
+
+/* Fake of the configurator API function */
+te_errno
+cfg_find_pattern_fmt(unsigned int *p_num, cfg_handle **p_set,
+                     const char *ptrn_fmt, ...)
+{
+    te_string       pattern = TE_STRING_INIT;
+    char            ta[64];
+    char            ifname[64];
+    unsigned int    i;
+    va_list         ap;
+
+    va_start(ap, ptrn_fmt);
+    te_string_append_va(&pattern, ptrn_fmt, ap);
+    va_end(ap);
+
+    LIBTS_UNIT_CHECK(sscanf(pattern.ptr,
+                            "/agent:%63[^/]/interface:%63[^/]/net_addr:*",
+                            ta, ifname) == 2);
+    te_string_free(&pattern);
+
+    *p_num = 0;
+    *p_set = calloc(TE_ARRAY_LEN(fake_cfg), sizeof(**p_set));
+    for (i = 0; i < TE_ARRAY_LEN(fake_cfg); i++)
+    {
+        if (fake_match(ta, fake_cfg[i].ta) &&
+            fake_match(ifname, fake_cfg[i].ifname))
+            (*p_set)[(*p_num)++] = i;
+    }
+
+    return 0;
+}
+
+/* Fake of the configurator API function */
+te_errno
+cfg_get_inst_name(cfg_handle handle, char **name)
+{
+    fake_requests++;
+    *name = strdup(fake_cfg[handle].addr);
+    return 0;
+}
+
+/* Fake of the configurator API function */
+te_errno
+cfg_get_oid(cfg_handle handle, cfg_oid **oid)
+{
+    te_string str = TE_STRING_INIT;
+
+    fake_requests++;
+    te_string_append(&str, "/agent:%s/interface:%s/net_addr:%s",
+                     fake_cfg[handle].ta, fake_cfg[handle].ifname,
+                     fake_cfg[handle].addr);
+    *oid = cfg_convert_oid_str(str.ptr);
+    te_string_free(&str);
+
+    return *oid == NULL ? TE_RC(TE_CS, TE_EINVAL) : 0;
+}
+
+/* Fake of the configurator API function */
+te_errno
+cfg_get_int32(int32_t *value, const char *oid_fmt, ...)
+{
+    te_string       oid = TE_STRING_INIT;
+    te_string       expected = TE_STRING_INIT;
+    unsigned int    i;
+    te_errno        rc = TE_RC(TE_CS, TE_ENOENT);
+    va_list         ap;
+
+    fake_prefix_requests++;
+
+    va_start(ap, oid_fmt);
+    te_string_append_va(&oid, oid_fmt, ap);
+    va_end(ap);
+
+    for (i = 0; i < TE_ARRAY_LEN(fake_cfg); i++)
+    {
+        te_string_free(&expected);
+        te_string_append(&expected, "/agent:%s/interface:%s/net_addr:%s",
+                         fake_cfg[i].ta, fake_cfg[i].ifname,
+                         fake_cfg[i].addr);
+        if (strcmp(expected.ptr, oid.ptr) == 0 && fake_cfg[i].prefix >= 0)
+        {
+            *value = fake_cfg[i].prefix;
+            rc = 0;
+            break;
+        }
+    }
+
+    te_string_free(&expected);
+    te_string_free(&oid);
+    return rc;
+}
+
+/**
+ * Make a socket address.
+ *
+ * @param str       Address string.
+ * @param addr      Where to put the address.
+ *
+ * @return The address.
+ */
+static const struct sockaddr *
+make_addr(const char *str, struct sockaddr_storage *addr)
+{
+    memset(addr, 0, sizeof(*addr));
+    LIBTS_UNIT_CHECK(te_sockaddr_str2h(str, SA(addr)) == 0);
+    return SA(addr);
+}
+
+/**
+ * Check the order of the snapshot and that invalid addresses are
+ * skipped.
+ */
+static void
+test_snapshot(void)
+{
+    static const char  *expected[] = { "192.168.0.2", "192.168.1.2",
+                                       "fe80::2", "10.0.1.2", "10.0.0.2",
+                                       "fe80::1" };
+    libts_addrs         addrs;
+    unsigned int        i;
+
+    fake_requests = 0;
+    LIBTS_UNIT_CHECK(libts_addrs_get(&addrs) == 0);
+    LIBTS_UNIT_CHECK(fake_requests == TE_ARRAY_LEN(fake_cfg));
+
+    LIBTS_UNIT_CHECK(addrs.n_addrs == TE_ARRAY_LEN(expected));
+    for (i = 0; i < addrs.n_addrs && i < TE_ARRAY_LEN(expected); i++)
+    {
+        LIBTS_UNIT_CHECK(strcmp(addrs.addrs[i].str, expected[i]) == 0);
+        LIBTS_UNIT_CHECK(addrs.addrs[i].prefix == -1);
+    }
+    LIBTS_UNIT_CHECK(strcmp(addrs.addrs[0].ta, "Agt_A") == 0);
+    LIBTS_UNIT_CHECK(strcmp(addrs.addrs[0].ifname, "eth0") == 0);
+    libts_addrs_free(&addrs);
+
+    /* The snapshot is kept */
+    LIBTS_UNIT_CHECK(libts_addrs_get(&addrs) == 0);
+    LIBTS_UNIT_CHECK(fake_requests == TE_ARRAY_LEN(fake_cfg));
+    LIBTS_UNIT_CHECK(addrs.n_addrs == TE_ARRAY_LEN(expected));
+    libts_addrs_free(&addrs);
+}
+
+/**
+ * Check lookups of addresses.
+ */
+static void
+test_find(void)
+{
+    libts_addrs         addrs;
+    const libts_addr   *addr;
+    unsigned int        n;
+
+    LIBTS_UNIT_CHECK(libts_addrs_get(&addrs) == 0);
+
+    addr = libts_addrs_find(&addrs, "Agt_A", "eth0", AF_INET, &n);
+    LIBTS_UNIT_CHECK(addr != NULL && n == 2);
+    LIBTS_UNIT_CHECK(addr != NULL &&
+                     strcmp(addr->str, "192.168.0.2") == 0);
+
+    addr = libts_addrs_find(&addrs, "Agt_A", "eth0", AF_UNSPEC, &n);
+    LIBTS_UNIT_CHECK(addr != NULL && n == 3);
+
+    addr = libts_addrs_find(&addrs, "Agt_A", NULL, AF_UNSPEC, &n);
+    LIBTS_UNIT_CHECK(addr != NULL && n == 5);
+
+    addr = libts_addrs_find(&addrs, "Agt_A", NULL, AF_INET6, &n);
+    LIBTS_UNIT_CHECK(addr != NULL && n == 1);
+    LIBTS_UNIT_CHECK(addr != NULL && strcmp(addr->str, "fe80::2") == 0);
+
+    addr = libts_addrs_find(&addrs, "Agt_A", "eth1", AF_INET6, &n);
+    LIBTS_UNIT_CHECK(addr == NULL && n == 0);
+
+    addr = libts_addrs_find(&addrs, "Agt_B", "eth1", AF_INET6, NULL);
+    LIBTS_UNIT_CHECK(addr != NULL && strcmp(addr->str, "fe80::1") == 0);
+
+    LIBTS_UNIT_CHECK(libts_addrs_find(&addrs, "Agt_C", NULL, AF_UNSPEC,
+                                      &n) == NULL && n == 0);
+    LIBTS_UNIT_CHECK(libts_addrs_find(&addrs, "Agt_0", NULL, AF_UNSPEC,
+                                      NULL) == NULL);
+
+    libts_addrs_free(&addrs);
+}
+
+/**
+ * Check lookups of addresses by subnet and by prefix match, and that
+ * prefixes are taken only once and only for the matched family.
+ */
+static void
+test_subnet(void)
+{
+    struct sockaddr_storage net;
+    libts_addrs             addrs;
+    const libts_addr       *addr;
+
+    LIBTS_UNIT_CHECK(libts_addrs_get(&addrs) == 0);
+
+    addr = libts_addrs_find_subnet(&addrs, "Agt_A", NULL,
+                                   make_addr("192.168.1.0", &net), 24);
+    LIBTS_UNIT_CHECK(addr != NULL && strcmp(addr->str, "192.168.1.2") == 0);
+    addr = libts_addrs_find_subnet(&addrs, "Agt_A", "eth1",
+                                   make_addr("10.0.0.0", &net), 23);
+    LIBTS_UNIT_CHECK(addr != NULL && strcmp(addr->str, "10.0.1.2") == 0);
+    addr = libts_addrs_find_subnet(&addrs, "Agt_A", "eth1",
+                                   make_addr("10.0.0.0", &net), 24);
+    LIBTS_UNIT_CHECK(addr != NULL && strcmp(addr->str, "10.0.0.2") == 0);
+    addr = libts_addrs_find_subnet(&addrs, "Agt_A", NULL,
+                                   make_addr("172.16.0.0", &net), 12);
+    LIBTS_UNIT_CHECK(addr == NULL);
+    addr = libts_addrs_find_subnet(&addrs, "Agt_A", NULL,
+                                   make_addr("0.0.0.0", &net), 0);
+    LIBTS_UNIT_CHECK(addr != NULL && strcmp(addr->str, "192.168.0.2") == 0);
+    addr = libts_addrs_find_subnet(&addrs, "Agt_A", NULL,
+                                   make_addr("10.0.0.0", &net), 33);
+    LIBTS_UNIT_CHECK(addr == NULL);
+
+    fake_prefix_requests = 0;
+    addr = libts_addrs_match_prefix(&addrs, "Agt_A",
+                                    make_addr("192.168.1.77", &net));
+    LIBTS_UNIT_CHECK(addr != NULL && strcmp(addr->str, "192.168.1.2") == 0);
+    LIBTS_UNIT_CHECK(addr != NULL && addr->prefix == 24);
+    LIBTS_UNIT_CHECK(fake_prefix_requests == 4);
+
+    /* Only the prefix which cannot be got is requested again */
+    addr = libts_addrs_match_prefix(&addrs, "Agt_A",
+                                    make_addr("192.168.7.1", &net));
+    LIBTS_UNIT_CHECK(addr != NULL && strcmp(addr->str, "192.168.0.2") == 0);
+    LIBTS_UNIT_CHECK(fake_prefix_requests == 5);
+
+    addr = libts_addrs_match_prefix(&addrs, "Agt_A",
+                                    make_addr("10.0.0.5", &net));
+    LIBTS_UNIT_CHECK(addr == NULL);
+
+    libts_addrs_free(&addrs);
+}
+
+/**
+ * Check that libts_addrs_get_first() stops at the first address of the
+ * family if there is no kept snapshot and does not make requests if
+ * there is one.
+ */
+static void
+test_get_first(void)
+{
+    libts_addrs addrs;
+
+    libts_addrs_invalidate();
+
+    fake_requests = 0;
+    LIBTS_UNIT_CHECK(libts_addrs_get_first("Agt_A", "eth1", AF_INET,
+                                           &addrs) == 0);
+    LIBTS_UNIT_CHECK(fake_requests == 1);
+    LIBTS_UNIT_CHECK(addrs.n_addrs == 1 &&
+                     strcmp(addrs.addrs[0].str, "10.0.1.2") == 0);
+    libts_addrs_free(&addrs);
+
+    fake_requests = 0;
+    LIBTS_UNIT_CHECK(libts_addrs_get_first("Agt_A", "eth0", AF_INET6,
+                                           &addrs) == 0);
+    LIBTS_UNIT_CHECK(fake_requests == 2);
+    LIBTS_UNIT_CHECK(addrs.n_addrs == 1 &&
+                     strcmp(addrs.addrs[0].str, "fe80::2") == 0);
+    libts_addrs_free(&addrs);
+
+    fake_requests = 0;
+    LIBTS_UNIT_CHECK(libts_addrs_get_first("Agt_A", "eth1", AF_INET6,
+                                           &addrs) == 0);
+    LIBTS_UNIT_CHECK(fake_requests == 3);
+    LIBTS_UNIT_CHECK(addrs.n_addrs == 0);
+    libts_addrs_free(&addrs);
+
+    LIBTS_UNIT_CHECK(libts_addrs_get(&addrs) == 0);
+    libts_addrs_free(&addrs);
+
+    fake_requests = 0;
+    LIBTS_UNIT_CHECK(libts_addrs_get_first("Agt_B", "eth1", AF_INET6,
+                                           &addrs) == 0);
+    LIBTS_UNIT_CHECK(fake_requests == 0);
+    LIBTS_UNIT_CHECK(addrs.n_addrs == 1 &&
+                     strcmp(addrs.addrs[0].str, "fe80::1") == 0);
+    libts_addrs_free(&addrs);
+}
+
+int
+main(void)
+{
+    test_snapshot();
+    test_find();
+    test_subnet();
+    test_get_first();
+
+    libts_addrs_invalidate();
+    return libts_unit_result();
+}
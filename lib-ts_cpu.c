@@ -0,0 +1,374 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief CPU isolation API
+ *
+ * Implementation of CPU isolation functions.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts CPU"
+
+#include "lib-ts.h"
+#include "lib-ts_netns.h"
+#include "lib-ts_cpu.h"
+#include "tapi_rpc_unistd.h"
+
+/** Restore script of changed settings on IUT host */
+#define CPU_RESTORE_FILE "/var/tmp/libts_cpu_restore.sh"
+
+/**
+ * Shell function restoring affinity of a pinned RPC server:
+ * pin <pid> <start time> <CPU list>. The process is skipped if it is
+ * gone or the PID is reused by another process, i.e. its start time
+ * (field 22 of /proc/<pid>/stat) differs from the saved one.
+ */
+#define CPU_RESTORE_PIN \
+    "pin() { " \
+    "s=$(sed 's/.*) //' /proc/$1/stat 2>/dev/null | cut -d' ' -f20); " \
+    "test -n \"$s\" -a \"$s\" = \"$2\" || return 0; " \
+    "taskset -a -p -c $3 $1 >/dev/null 2>&1; }"
+
+/** Maximum number of CPUs supported in CPU lists */
+#define CPU_MAX 4096
+
+/**
+ * Parse CPU list, e.g. "0-3,8,10-11".
+ *
+ * @param str       CPU list.
+ * @param cpus      Where to set flags of listed CPUs (@c CPU_MAX
+ *                  elements).
+ *
+ * @return Status code.
+ */
+static te_errno
+cpu_list_parse(const char *str, te_bool *cpus)
+{
+    const char     *p = str;
+    char           *end;
+    unsigned long   first;
+    unsigned long   last;
+
+    memset(cpus, 0, CPU_MAX * sizeof(*cpus));
+
+    while (*p != '\0' && *p != '\n')
+    {
+        first = strtoul(p, &end, 10);
+        if (end == p)
+            goto fail;
+        last = first;
+        if (*end == '-')
+        {
+            p = end + 1;
+            last = strtoul(p, &end, 10);
+            if (end == p)
+                goto fail;
+        }
+        if (first > last || last >= CPU_MAX)
+            goto fail;
+
+        while (first <= last)
+            cpus[first++] = TRUE;
+
+        p = end;
+        if (*p == ',')
+            p++;
+        else if (*p != '\0' && *p != '\n')
+            goto fail;
+    }
+
+    return 0;
+
+fail:
+    ERROR("Invalid CPU list '%s'", str);
+    return TE_RC(TE_TAPI, TE_EINVAL);
+}
+
+/**
+ * Format CPU list.
+ *
+ * @param cpus      Flags of CPUs (@c CPU_MAX elements).
+ * @param str       Where to append the list.
+ *
+ * @return Status code.
+ */
+static te_errno
+cpu_list_format(const te_bool *cpus, te_string *str)
+{
+    unsigned int    first;
+    unsigned int    i;
+    te_errno        rc = 0;
+
+    for (i = 0; i < CPU_MAX && rc == 0; i++)
+    {
+        if (!cpus[i])
+            continue;
+
+        first = i;
+        while (i + 1 < CPU_MAX && cpus[i + 1])
+            i++;
+
+        rc = te_string_append(str, "%s%u", str->len == 0 ? "" : ",",
+                              first);
+        if (rc == 0 && i > first)
+            rc = te_string_append(str, "-%u", i);
+    }
+
+    return rc;
+}
+
+/**
+ * Get CPU list for interrupts: all online CPUs of an agent host except
+ * the isolated ones.
+ *
+ * @param ta        Test agent.
+ * @param rpc_cores Isolated CPU list.
+ * @param str       Where to append the list.
+ *
+ * @return Status code.
+ */
+static te_errno
+cpu_get_irq_cores(const char *ta, const char *rpc_cores, te_string *str)
+{
+    te_bool    *online;
+    te_bool    *isolated;
+    char       *out = NULL;
+    te_bool     found = FALSE;
+    unsigned int i;
+    te_errno    rc;
+
+    online = calloc(CPU_MAX, sizeof(*online));
+    isolated = calloc(CPU_MAX, sizeof(*isolated));
+    if (online == NULL || isolated == NULL)
+    {
+        rc = TE_RC(TE_TAPI, TE_ENOMEM);
+        goto out;
+    }
+
+    rc = libts_ta_shell_get(ta, &out, "cat /sys/devices/system/cpu/online");
+    if (rc == 0)
+        rc = cpu_list_parse(out, online);
+    if (rc == 0)
+        rc = cpu_list_parse(rpc_cores, isolated);
+    if (rc != 0)
+        goto out;
+
+    for (i = 0; i < CPU_MAX; i++)
+    {
+        online[i] = online[i] && !isolated[i];
+        found = found || online[i];
+    }
+
+    if (!found)
+    {
+        ERROR("No online CPUs are left for interrupts on %s", ta);
+        rc = TE_RC(TE_TAPI, TE_EINVAL);
+        goto out;
+    }
+
+    rc = cpu_list_format(online, str);
+
+out:
+    free(out);
+    free(online);
+    free(isolated);
+    return rc;
+}
+
+/**
+ * Append shell commands executing the restore script (if it exists) and
+ * removing it. Exit status of the script is put to @c rc shell variable.
+ *
+ * @param cmd       Where to append the commands.
+ *
+ * @return Status code.
+ */
+static te_errno
+cpu_restore_cmd(te_string *cmd)
+{
+    te_string   pin = TE_STRING_INIT;
+    te_errno    rc;
+
+    rc = libts_shell_quote(&pin, CPU_RESTORE_PIN);
+    if (rc == 0)
+    {
+        rc = te_string_append(cmd,
+                              "r=" CPU_RESTORE_FILE "; rc=0; "
+                              "if test -e $r; then "
+                              "{ echo %s; tac $r; } | sh || rc=$?; "
+                              "rm -f $r; fi",
+                              pin.ptr);
+    }
+
+    te_string_free(&pin);
+    return rc;
+}
+
+/* See description in lib-ts_cpu.h */
+void
+libts_cpu_profile_init(libts_cpu_profile *profile)
+{
+    profile->rpc_cores = getenv("SFC_ONLOAD_CPU_RPC_CORES");
+    if (profile->rpc_cores != NULL && profile->rpc_cores[0] == '\0')
+        profile->rpc_cores = NULL;
+
+    profile->irq_cores = getenv("SFC_ONLOAD_CPU_IRQ_CORES");
+    if (profile->irq_cores != NULL && profile->irq_cores[0] == '\0')
+        profile->irq_cores = NULL;
+
+    profile->keep_irqbalance =
+        tapi_getenv_bool("SFC_ONLOAD_CPU_KEEP_IRQBALANCE");
+}
+
+/* See description in lib-ts_cpu.h */
+te_errno
+libts_cpu_isolate(const libts_cpu_profile *profile)
+{
+    static const char *iut_ifs[] = { "TE_ORIG_IUT_TST1",
+                                     "TE_ORIG_IUT_TST1_IUT",
+                                     "TE_ORIG_IUT_TST1_IUT2",
+                                     "TE_ORIG_IUT_TST1_IUT3"
+                                   };
+    te_string       irq_cores = TE_STRING_INIT;
+    te_string       ifs = TE_STRING_INIT;
+    te_string       cmd = TE_STRING_INIT;
+    const char     *ifname;
+    char           *ta = NULL;
+    char           *out = NULL;
+    unsigned int    i;
+    te_errno        rc;
+
+    if (profile->rpc_cores == NULL)
+        return 0;
+
+    rc = libts_netns_get_sfc_ta(&ta);
+    if (rc != 0)
+        return rc;
+
+    if (profile->irq_cores != NULL)
+        rc = te_string_append(&irq_cores, "%s", profile->irq_cores);
+    else
+        rc = cpu_get_irq_cores(ta, profile->rpc_cores, &irq_cores);
+
+    for (i = 0; rc == 0 && i < TE_ARRAY_LEN(iut_ifs); i++)
+    {
+        ifname = libts_netns_slot_getenv(iut_ifs[i]);
+        if (ifname != NULL && ifname[0] != '\0')
+        {
+            rc = te_string_append(&ifs, " ");
+            if (rc == 0)
+                rc = libts_shell_quote(&ifs, ifname);
+        }
+    }
+    /*
+     * A script left by a run which did not call libts_cpu_restore() is
+     * executed first: otherwise the isolated settings would be saved as
+     * the original ones.
+     */
+    if (rc == 0)
+        rc = cpu_restore_cmd(&cmd);
+    if (rc != 0)
+        goto out;
+
+    /*
+     * irqbalance is stopped first, otherwise it can move interrupts
+     * back. Every setting is saved to the restore script before it is
+     * changed, the script is executed in the reverse order.
+     */
+    rc = libts_ta_shell_get(ta, &out,
+            "%s; test $rc -eq 0 || "
+            "echo 'Settings of a previous run are not fully restored'; "
+            "if %s && systemctl -q is-active irqbalance; then "
+            "echo 'systemctl start irqbalance' >>$r; "
+            "systemctl stop irqbalance || exit 1; "
+            "echo 'irqbalance is stopped'; fi; "
+            "n=0; for i in%s; do "
+            "for irq in $(ls /sys/class/net/$i/device/msi_irqs "
+            "2>/dev/null); do "
+            "f=/proc/irq/$irq/smp_affinity_list; "
+            "test -e $f || continue; old=$(cat $f); "
+            "if echo %s >$f 2>/dev/null; then "
+            "echo \"echo $old >$f\" >>$r; n=$((n+1)); "
+            "else echo \"IRQ $irq of $i cannot be moved\"; fi; "
+            "done; done; echo \"$n IRQs are moved to CPUs %s\"",
+            cmd.ptr, profile->keep_irqbalance ? "false" : "true",
+            ifs.len == 0 ? "" : ifs.ptr, irq_cores.ptr, irq_cores.ptr);
+    if (rc == 0)
+        RING("CPU isolation of %s on %s:\n%s", profile->rpc_cores, ta, out);
+    else
+        ERROR("Failed to isolate CPUs %s on %s: %r", profile->rpc_cores,
+              ta, rc);
+
+out:
+    free(out);
+    free(ta);
+    te_string_free(&cmd);
+    te_string_free(&ifs);
+    te_string_free(&irq_cores);
+    return rc;
+}
+
+/* See description in lib-ts_cpu.h */
+te_errno
+libts_cpu_pin_rpcs(const libts_cpu_profile *profile, rcf_rpc_server *rpcs)
+{
+    pid_t       pid;
+    te_errno    rc;
+
+    if (profile->rpc_cores == NULL)
+        return 0;
+
+    pid = rpc_getpid(rpcs);
+
+    /*
+     * Start time of the process is saved together with its PID, so the
+     * affinity is not changed if the PID is reused before restoring.
+     */
+    rc = libts_ta_shell(rpcs->ta, NULL,
+                        "p=%d; old=$(taskset -p -c $p | sed 's/.*: //') && "
+                        "s=$(sed 's/.*) //' /proc/$p/stat | "
+                        "cut -d' ' -f20) && "
+                        "echo \"pin $p $s $old\" >>" CPU_RESTORE_FILE
+                        " && taskset -a -p -c %s $p >/dev/null",
+                        (int)pid, profile->rpc_cores);
+    if (rc != 0)
+    {
+        ERROR("Failed to pin RPC server %s to CPUs %s: %r", rpcs->name,
+              profile->rpc_cores, rc);
+        return rc;
+    }
+
+    RING("RPC server %s (pid %d) is pinned to CPUs %s", rpcs->name,
+         (int)pid, profile->rpc_cores);
+    return 0;
+}
+
+/* See description in lib-ts_cpu.h */
+te_errno
+libts_cpu_restore(void)
+{
+    const char *ta = getenv("TE_IUT_TA_NAME");
+    te_string   cmd = TE_STRING_INIT;
+    int         status;
+    te_errno    rc;
+
+    if (ta == NULL)
+    {
+        ERROR("Cannot get IUT agent name");
+        return TE_RC(TE_TAPI, TE_ENOENT);
+    }
+
+    rc = cpu_restore_cmd(&cmd);
+    /* The host agent is used since the namespace may be removed */
+    if (rc == 0)
+        rc = libts_ta_shell(ta, &status, "%s; exit $rc", cmd.ptr);
+    if (rc == 0 && status != 0)
+    {
+        ERROR("Some CPU isolation settings are not restored on %s", ta);
+        rc = TE_RC(TE_TAPI, TE_ESHCMD);
+    }
+
+    te_string_free(&cmd);
+    return rc;
+}
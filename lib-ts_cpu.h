@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief CPU isolation API
+ *
+ * Functions to isolate CPU cores for latency-sensitive runs on IUT:
+ * pin RPC servers to the chosen cores, steer interrupts of the testing
+ * SFC interfaces away from them and stop irqbalance.
+ *
+ * Every changed setting is saved on the IUT host to a restore script
+ * before it is changed, so the settings are restored by
+ * libts_cpu_restore() even if it is called by another process (e.g.
+ * in epilogue). A script left by a run which did not restore the
+ * settings is executed by libts_cpu_isolate() before changing anything.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_CPU_H__
+#define __ONLOAD_LIB_TS_CPU_H__
+
+#include "te_errno.h"
+#include "lib-ts.h"
+
+/**
+ * CPU isolation profile.
+ */
+typedef struct libts_cpu_profile {
+    const char *rpc_cores;      /**< CPU list (as for taskset -c) to pin
+                                     RPC servers to, @c NULL to disable
+                                     isolation */
+    const char *irq_cores;      /**< CPU list for interrupts of the
+                                     testing interfaces, @c NULL for all
+                                     online CPUs except @a rpc_cores */
+    te_bool     keep_irqbalance;    /**< Do not stop irqbalance */
+} libts_cpu_profile;
+
+/**
+ * Initialize CPU isolation profile from environment variables
+ * SFC_ONLOAD_CPU_RPC_CORES, SFC_ONLOAD_CPU_IRQ_CORES and
+ * SFC_ONLOAD_CPU_KEEP_IRQBALANCE.
+ *
+ * @param profile   Profile to initialize.
+ */
+extern void libts_cpu_profile_init(libts_cpu_profile *profile);
+
+/**
+ * Steer interrupts of the testing SFC interfaces (TE_ORIG_IUT_TST1*)
+ * away from the isolated cores and stop irqbalance. It should be called
+ * after libts_setup_namespace(), the interfaces are found on the agent
+ * returned by libts_netns_get_sfc_ta().
+ *
+ * @param profile   CPU isolation profile.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_cpu_isolate(const libts_cpu_profile *profile);
+
+/**
+ * Pin all threads of an RPC server to the isolated cores.
+ *
+ * @param profile   CPU isolation profile.
+ * @param rpcs      RPC server.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_cpu_pin_rpcs(const libts_cpu_profile *profile,
+                                   rcf_rpc_server *rpcs);
+
+/**
+ * Restore settings changed by libts_cpu_isolate() and
+ * libts_cpu_pin_rpcs() in the reverse order. Affinity of RPC servers
+ * which do not exist any more is not restored: a process is identified
+ * by its PID and start time, so a reused PID is skipped too.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_cpu_restore(void);
+
+#endif /* !__ONLOAD_LIB_TS_CPU_H__ */
@@ -0,0 +1,349 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Latency histogram API
+ *
+ * Implementation of fixed-memory histogram with logarithmic buckets.
+ *
+ * Values are split into buckets covering ranges [2^k * N, 2^(k+1) * N)
+ * where N is a number of sub-buckets in a bucket. Each bucket has N/2
+ * sub-buckets of width 2^k (the first bucket has N sub-buckets of width
+ * one), so a counter is found by the position of the highest set bit of
+ * the value and a shift.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Histogram"
+
+#include "lib-ts.h"
+#include "lib-ts_histogram.h"
+
+/** Prefix of serialized histogram */
+#define HISTOGRAM_STR_PREFIX "LTSH1"
+
+/**
+ * Get number of sub-buckets in a half of a bucket.
+ *
+ * @param hist      Histogram.
+ *
+ * @return Number of sub-buckets.
+ */
+static inline uint64_t
+sub_bucket_half_count(const libts_histogram *hist)
+{
+    return 1ULL << hist->sub_bucket_half_mag;
+}
+
+/**
+ * Get index of the counter of a value.
+ *
+ * @param hist      Histogram.
+ * @param value     Value.
+ *
+ * @return Counter index.
+ */
+static inline unsigned int
+counts_index(const libts_histogram *hist, uint64_t value)
+{
+    unsigned int    pow2ceiling;
+    unsigned int    bucket_idx;
+    uint64_t        sub_bucket_idx;
+
+    pow2ceiling = 64 - __builtin_clzll(value | hist->sub_bucket_mask);
+    bucket_idx = pow2ceiling - (hist->sub_bucket_half_mag + 1);
+    sub_bucket_idx = value >> bucket_idx;
+
+    return ((bucket_idx + 1) << hist->sub_bucket_half_mag) +
+           (sub_bucket_idx - sub_bucket_half_count(hist));
+}
+
+/**
+ * Get the highest value which is equivalent to values counted by
+ * a counter.
+ *
+ * @param hist      Histogram.
+ * @param idx       Counter index.
+ *
+ * @return The highest value.
+ */
+static uint64_t
+counts_index_highest_value(const libts_histogram *hist, unsigned int idx)
+{
+    int         bucket_idx = (int)(idx >> hist->sub_bucket_half_mag) - 1;
+    uint64_t    sub_bucket_idx = (idx & (sub_bucket_half_count(hist) - 1)) +
+                                 sub_bucket_half_count(hist);
+
+    if (bucket_idx < 0)
+    {
+        sub_bucket_idx -= sub_bucket_half_count(hist);
+        bucket_idx = 0;
+    }
+
+    return (sub_bucket_idx << bucket_idx) + (1ULL << bucket_idx) - 1;
+}
+
+/* See description in lib-ts_histogram.h */
+te_errno
+libts_histogram_init(libts_histogram *hist, uint64_t highest,
+                     unsigned int digits)
+{
+    uint64_t        largest_resolution = 2;
+    uint64_t        sub_bucket_count;
+    uint64_t        smallest_untrackable;
+    unsigned int    sub_bucket_mag = 0;
+    unsigned int    n_buckets = 1;
+    unsigned int    i;
+
+    memset(hist, 0, sizeof(*hist));
+
+    if (digits < 1 || digits > LIBTS_HISTOGRAM_DIGITS_MAX || highest < 2)
+    {
+        ERROR("%s(): wrong argument value", __FUNCTION__);
+        return TE_RC(TE_TAPI, TE_EINVAL);
+    }
+
+    for (i = 0; i < digits; i++)
+        largest_resolution *= 10;
+    while ((1ULL << sub_bucket_mag) < largest_resolution)
+        sub_bucket_mag++;
+
+    hist->highest = highest;
+    hist->digits = digits;
+    hist->sub_bucket_half_mag = sub_bucket_mag - 1;
+    sub_bucket_count = 1ULL << sub_bucket_mag;
+    hist->sub_bucket_mask = sub_bucket_count - 1;
+
+    for (smallest_untrackable = sub_bucket_count;
+         smallest_untrackable <= highest; n_buckets++)
+    {
+        if (smallest_untrackable > UINT64_MAX / 2)
+        {
+            n_buckets++;
+            break;
+        }
+        smallest_untrackable <<= 1;
+    }
+
+    hist->n_counts = (n_buckets + 1) * (sub_bucket_count / 2);
+    hist->counts = calloc(hist->n_counts, sizeof(*hist->counts));
+    if (hist->counts == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+
+    libts_histogram_reset(hist);
+    return 0;
+}
+
+/* See description in lib-ts_histogram.h */
+void
+libts_histogram_free(libts_histogram *hist)
+{
+    free(hist->counts);
+    hist->counts = NULL;
+    hist->n_counts = 0;
+}
+
+/* See description in lib-ts_histogram.h */
+void
+libts_histogram_reset(libts_histogram *hist)
+{
+    if (hist->counts != NULL)
+        memset(hist->counts, 0, hist->n_counts * sizeof(*hist->counts));
+    hist->total = 0;
+    hist->overflow = 0;
+    hist->min = UINT64_MAX;
+    hist->max = 0;
+    hist->sum = 0;
+}
+
+/* See description in lib-ts_histogram.h */
+void
+libts_histogram_record_n(libts_histogram *hist, uint64_t value,
+                         uint64_t count)
+{
+    if (count == 0)
+        return;
+
+    if (value > hist->highest)
+        hist->overflow += count;
+    else
+        hist->counts[counts_index(hist, value)] += count;
+
+    hist->total += count;
+    hist->sum += (double)value * count;
+    if (value < hist->min)
+        hist->min = value;
+    if (value > hist->max)
+        hist->max = value;
+}
+
+/* See description in lib-ts_histogram.h */
+te_errno
+libts_histogram_merge(libts_histogram *dst, const libts_histogram *src)
+{
+    unsigned int i;
+
+    if (dst->highest != src->highest || dst->digits != src->digits)
+    {
+        ERROR("Histograms with different layout cannot be merged");
+        return TE_RC(TE_TAPI, TE_EINVAL);
+    }
+
+    for (i = 0; i < dst->n_counts; i++)
+        dst->counts[i] += src->counts[i];
+
+    dst->total += src->total;
+    dst->overflow += src->overflow;
+    dst->sum += src->sum;
+    if (src->min < dst->min)
+        dst->min = src->min;
+    if (src->max > dst->max)
+        dst->max = src->max;
+
+    return 0;
+}
+
+/* See description in lib-ts_histogram.h */
+uint64_t
+libts_histogram_percentile(const libts_histogram *hist, double p)
+{
+    uint64_t        target;
+    uint64_t        acc = 0;
+    uint64_t        value;
+    unsigned int    i;
+
+    if (hist->total == 0)
+        return 0;
+
+    if (p < 0)
+        p = 0;
+    if (p > 100)
+        p = 100;
+
+    target = (uint64_t)(p / 100. * hist->total + 0.5);
+    if (target == 0)
+        target = 1;
+
+    for (i = 0; i < hist->n_counts; i++)
+    {
+        acc += hist->counts[i];
+        if (acc >= target)
+        {
+            value = counts_index_highest_value(hist, i);
+            return value < hist->max ? value : hist->max;
+        }
+    }
+
+    /* The percentile falls into overflowed values */
+    return hist->max;
+}
+
+/* See description in lib-ts_histogram.h */
+double
+libts_histogram_mean(const libts_histogram *hist)
+{
+    return hist->total == 0 ? 0 : hist->sum / hist->total;
+}
+
+/* See description in lib-ts_histogram.h */
+te_errno
+libts_histogram_to_str(const libts_histogram *hist, te_string *str)
+{
+    unsigned int    prev = 0;
+    unsigned int    i;
+    te_errno        rc;
+
+    rc = te_string_append(str, HISTOGRAM_STR_PREFIX " %llu %u %llu %llu "
+                          "%.17g %llu", (unsigned long long)hist->highest,
+                          hist->digits, (unsigned long long)hist->min,
+                          (unsigned long long)hist->max, hist->sum,
+                          (unsigned long long)hist->overflow);
+
+    /* Indices are delta-encoded to keep the string short */
+    for (i = 0; rc == 0 && i < hist->n_counts; i++)
+    {
+        if (hist->counts[i] == 0)
+            continue;
+
+        rc = te_string_append(str, " %u:%llu", i - prev,
+                              (unsigned long long)hist->counts[i]);
+        prev = i;
+    }
+
+    return rc;
+}
+
+/* See description in lib-ts_histogram.h */
+te_errno
+libts_histogram_from_str(libts_histogram *hist, const char *str)
+{
+    unsigned long long  highest;
+    unsigned long long  min;
+    unsigned long long  max;
+    unsigned long long  overflow;
+    unsigned long long  count;
+    unsigned int        digits;
+    unsigned int        delta;
+    unsigned int        idx = 0;
+    double              sum;
+    int                 len;
+    te_errno            rc;
+
+    if (sscanf(str, HISTOGRAM_STR_PREFIX " %llu %u %llu %llu %lg %llu%n",
+               &highest, &digits, &min, &max, &sum, &overflow, &len) != 6)
+    {
+        ERROR("Invalid serialized histogram header: %s", str);
+        return TE_RC(TE_TAPI, TE_EINVAL);
+    }
+
+    rc = libts_histogram_init(hist, highest, digits);
+    if (rc != 0)
+        return rc;
+
+    for (str += len; *str != '\0'; str += len)
+    {
+        if (sscanf(str, " %u:%llu%n", &delta, &count, &len) != 2 ||
+            idx + delta >= hist->n_counts)
+        {
+            ERROR("Invalid serialized histogram counter: %s", str);
+            libts_histogram_free(hist);
+            return TE_RC(TE_TAPI, TE_EINVAL);
+        }
+
+        idx += delta;
+        hist->counts[idx] = count;
+        hist->total += count;
+    }
+
+    hist->overflow = overflow;
+    hist->total += overflow;
+    hist->min = min;
+    hist->max = max;
+    hist->sum = sum;
+
+    return 0;
+}
+
+/* See description in lib-ts_histogram.h */
+void
+libts_histogram_log(const libts_histogram *hist, const char *title)
+{
+    if (hist->total == 0)
+    {
+        RING("%s: no values recorded", title);
+        return;
+    }
+
+    RING("%s: %llu values (%llu overflowed)\n"
+         "min/mean/max: %llu / %.1f / %llu\n"
+         "p50/p90/p99/p99.9/p99.99: %llu / %llu / %llu / %llu / %llu",
+         title, (unsigned long long)hist->total,
+         (unsigned long long)hist->overflow,
+         (unsigned long long)hist->min, libts_histogram_mean(hist),
+         (unsigned long long)hist->max,
+         (unsigned long long)libts_histogram_percentile(hist, 50),
+         (unsigned long long)libts_histogram_percentile(hist, 90),
+         (unsigned long long)libts_histogram_percentile(hist, 99),
+         (unsigned long long)libts_histogram_percentile(hist, 99.9),
+         (unsigned long long)libts_histogram_percentile(hist, 99.99));
+}
@@ -0,0 +1,167 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Latency histogram API
+ *
+ * Fixed-memory histogram with logarithmic buckets (in the style of
+ * HdrHistogram) to record large number of latency samples, merge them
+ * and get percentiles.
+ *
+ * Values are recorded with the precision of the given number of
+ * significant decimal digits: a recorded value is indistinguishable
+ * from the other values in the range of its bucket which is not wider
+ * than @c 10^-digits of the value.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_HISTOGRAM_H__
+#define __ONLOAD_LIB_TS_HISTOGRAM_H__
+
+#include "te_errno.h"
+#include "lib-ts.h"
+
+/** Maximum number of significant decimal digits of a histogram */
+#define LIBTS_HISTOGRAM_DIGITS_MAX 5
+
+/**
+ * Histogram of non-negative integer values.
+ */
+typedef struct libts_histogram {
+    uint64_t        highest;            /**< Highest trackable value */
+    unsigned int    digits;             /**< Significant decimal digits */
+    unsigned int    sub_bucket_half_mag; /**< log2 of half of number of
+                                              sub-buckets in a bucket */
+    uint64_t        sub_bucket_mask;    /**< Mask of values which fall
+                                             into the first bucket */
+    unsigned int    n_counts;           /**< Number of counters */
+    uint64_t       *counts;             /**< Counters */
+    uint64_t        total;              /**< Number of recorded values */
+    uint64_t        overflow;           /**< Number of values higher than
+                                             @p highest */
+    uint64_t        min;                /**< Minimum recorded value */
+    uint64_t        max;                /**< Maximum recorded value */
+    double          sum;                /**< Sum of recorded values */
+} libts_histogram;
+
+/**
+ * Initialize a histogram.
+ *
+ * @param hist      Histogram to initialize.
+ * @param highest   Highest value to track (values higher than it are
+ *                  only counted as overflow).
+ * @param digits    Number of significant decimal digits to keep
+ *                  (1 - @c LIBTS_HISTOGRAM_DIGITS_MAX).
+ *
+ * @return Status code.
+ */
+extern te_errno libts_histogram_init(libts_histogram *hist,
+                                     uint64_t highest, unsigned int digits);
+
+/**
+ * Release resources allocated for a histogram.
+ *
+ * @param hist      Histogram.
+ */
+extern void libts_histogram_free(libts_histogram *hist);
+
+/**
+ * Remove all recorded values from a histogram.
+ *
+ * @param hist      Histogram.
+ */
+extern void libts_histogram_reset(libts_histogram *hist);
+
+/**
+ * Record a value in a histogram @p count times.
+ *
+ * @param hist      Histogram.
+ * @param value     Value to record.
+ * @param count     Number of times to record the value.
+ */
+extern void libts_histogram_record_n(libts_histogram *hist, uint64_t value,
+                                     uint64_t count);
+
+/**
+ * Record a value in a histogram.
+ *
+ * @param hist      Histogram.
+ * @param value     Value to record.
+ */
+static inline void
+libts_histogram_record(libts_histogram *hist, uint64_t value)
+{
+    libts_histogram_record_n(hist, value, 1);
+}
+
+/**
+ * Add all values recorded in one histogram to another one. Histograms
+ * must be initialized with the same highest trackable value and number
+ * of significant digits.
+ *
+ * @param dst       Histogram to add values to.
+ * @param src       Histogram to take values from.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_histogram_merge(libts_histogram *dst,
+                                      const libts_histogram *src);
+
+/**
+ * Get value at the given percentile, i.e. the highest value which is
+ * equivalent to the value such that @p p percents of recorded values
+ * are not higher than it.
+ *
+ * @param hist      Histogram.
+ * @param p         Percentile (0 - 100).
+ *
+ * @return Value at the percentile or @c 0 if the histogram is empty.
+ */
+extern uint64_t libts_histogram_percentile(const libts_histogram *hist,
+                                           double p);
+
+/**
+ * Get mean of recorded values.
+ *
+ * @param hist      Histogram.
+ *
+ * @return Mean value or @c 0 if the histogram is empty.
+ */
+extern double libts_histogram_mean(const libts_histogram *hist);
+
+/**
+ * Serialize a histogram to a compact string which contains non-zero
+ * counters only, so it can be passed via RPC or configurator cheaply.
+ *
+ * @param hist      Histogram.
+ * @param str       String to append serialized histogram to.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_histogram_to_str(const libts_histogram *hist,
+                                       te_string *str);
+
+/**
+ * Restore a histogram from a string produced by
+ * libts_histogram_to_str().
+ *
+ * @param hist      Histogram to initialize (should be released with
+ *                  libts_histogram_free()).
+ * @param str       Serialized histogram.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_histogram_from_str(libts_histogram *hist,
+                                         const char *str);
+
+/**
+ * Log summary of a histogram: number of values, min, mean, max and
+ * common percentiles.
+ *
+ * @param hist      Histogram.
+ * @param title     Title of the log message.
+ */
+extern void libts_histogram_log(const libts_histogram *hist,
+                                const char *title);
+
+#endif /* !__ONLOAD_LIB_TS_HISTOGRAM_H__ */
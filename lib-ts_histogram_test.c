@@ -0,0 +1,187 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Latency histogram API unit test
+ *
+ * Checks of bucketing precision, percentiles, merging and
+ * serialization of histograms.
+ *
+ * @author agent <agent@local>
+ */
+
+#include "lib-ts_histogram.c"
+#include "lib-ts_unit.h"
+
+DEFINE_LGR_ENTITY("libts_histogram_test");
+
+/**
+ * Check that every value is counted by a counter whose highest
+ * equivalent value is not lower than the value and is within the
+ * precision of the histogram.
+ */
+static void
+test_precision(void)
+{
+    libts_histogram hist;
+    uint64_t        value;
+    uint64_t        highest;
+    unsigned int    idx;
+
+    LIBTS_UNIT_CHECK(libts_histogram_init(&hist, 10000000, 3) == 0);
+
+    for (value = 0; value <= hist.highest; value += 1 + value / 1000)
+    {
+        idx = counts_index(&hist, value);
+        LIBTS_UNIT_CHECK(idx < hist.n_counts);
+        highest = counts_index_highest_value(&hist, idx);
+        LIBTS_UNIT_CHECK(highest >= value);
+        LIBTS_UNIT_CHECK(highest - value <= value / 1000);
+    }
+
+    libts_histogram_free(&hist);
+}
+
+/**
+ * Check wrong arguments of libts_histogram_init().
+ */
+static void
+test_init_invalid(void)
+{
+    libts_histogram hist;
+
+    LIBTS_UNIT_CHECK(libts_histogram_init(&hist, 1000, 0) != 0);
+    LIBTS_UNIT_CHECK(libts_histogram_init(&hist, 1000,
+                                          LIBTS_HISTOGRAM_DIGITS_MAX + 1)
+                     != 0);
+    LIBTS_UNIT_CHECK(libts_histogram_init(&hist, 1, 3) != 0);
+}
+
+/**
+ * Check percentiles, mean, min, max and overflow of uniformly
+ * distributed values.
+ */
+static void
+test_percentiles(void)
+{
+    libts_histogram hist;
+    uint64_t        value;
+
+    LIBTS_UNIT_CHECK(libts_histogram_init(&hist, 100000, 3) == 0);
+
+    LIBTS_UNIT_CHECK(libts_histogram_percentile(&hist, 50) == 0);
+    LIBTS_UNIT_CHECK(libts_histogram_mean(&hist) == 0);
+
+    for (value = 1; value <= 10000; value++)
+        libts_histogram_record(&hist, value);
+    libts_histogram_record_n(&hist, 200000, 10);
+
+    LIBTS_UNIT_CHECK(hist.total == 10010);
+    LIBTS_UNIT_CHECK(hist.overflow == 10);
+    LIBTS_UNIT_CHECK(hist.min == 1);
+    LIBTS_UNIT_CHECK(hist.max == 200000);
+    LIBTS_UNIT_CHECK_DOUBLE(libts_histogram_mean(&hist),
+                            (10000 * 10001 / 2 + 2000000) / 10010., 1e-6);
+
+    value = libts_histogram_percentile(&hist, 50);
+    LIBTS_UNIT_CHECK(value >= 5005 && value <= 5005 + 5005 / 1000);
+    value = libts_histogram_percentile(&hist, 90);
+    LIBTS_UNIT_CHECK(value >= 9009 && value <= 9009 + 9009 / 1000);
+    LIBTS_UNIT_CHECK(libts_histogram_percentile(&hist, 0) == 1);
+    LIBTS_UNIT_CHECK(libts_histogram_percentile(&hist, 100) == 200000);
+
+    libts_histogram_reset(&hist);
+    LIBTS_UNIT_CHECK(hist.total == 0);
+    LIBTS_UNIT_CHECK(libts_histogram_percentile(&hist, 50) == 0);
+
+    libts_histogram_free(&hist);
+}
+
+/**
+ * Check merging of histograms.
+ */
+static void
+test_merge(void)
+{
+    libts_histogram a;
+    libts_histogram b;
+    libts_histogram c;
+
+    LIBTS_UNIT_CHECK(libts_histogram_init(&a, 100000, 2) == 0);
+    LIBTS_UNIT_CHECK(libts_histogram_init(&b, 100000, 2) == 0);
+    LIBTS_UNIT_CHECK(libts_histogram_init(&c, 100000, 3) == 0);
+
+    libts_histogram_record_n(&a, 10, 3);
+    libts_histogram_record_n(&b, 1000, 1);
+    libts_histogram_record_n(&b, 5, 1);
+
+    LIBTS_UNIT_CHECK(libts_histogram_merge(&a, &b) == 0);
+    LIBTS_UNIT_CHECK(a.total == 5);
+    LIBTS_UNIT_CHECK(a.min == 5);
+    LIBTS_UNIT_CHECK(a.max == 1000);
+    LIBTS_UNIT_CHECK(libts_histogram_percentile(&a, 60) == 10);
+    LIBTS_UNIT_CHECK_DOUBLE(libts_histogram_mean(&a), 1035 / 5., 1e-9);
+
+    LIBTS_UNIT_CHECK(libts_histogram_merge(&a, &c) != 0);
+
+    libts_histogram_free(&a);
+    libts_histogram_free(&b);
+    libts_histogram_free(&c);
+}
+
+/**
+ * Check that a histogram is restored from its string form and that
+ * invalid strings are rejected.
+ */
+static void
+test_serialization(void)
+{
+    te_string       str = TE_STRING_INIT;
+    libts_histogram hist;
+    libts_histogram restored;
+    uint64_t        value;
+    unsigned int    i;
+
+    LIBTS_UNIT_CHECK(libts_histogram_init(&hist, 1000000, 3) == 0);
+    for (value = 3; value < 1000000; value *= 3)
+        libts_histogram_record_n(&hist, value, value % 7 + 1);
+    libts_histogram_record(&hist, 2000000);
+
+    LIBTS_UNIT_CHECK(libts_histogram_to_str(&hist, &str) == 0);
+    LIBTS_UNIT_CHECK(libts_histogram_from_str(&restored, str.ptr) == 0);
+
+    LIBTS_UNIT_CHECK(restored.highest == hist.highest);
+    LIBTS_UNIT_CHECK(restored.digits == hist.digits);
+    LIBTS_UNIT_CHECK(restored.n_counts == hist.n_counts);
+    LIBTS_UNIT_CHECK(restored.total == hist.total);
+    LIBTS_UNIT_CHECK(restored.overflow == hist.overflow);
+    LIBTS_UNIT_CHECK(restored.min == hist.min);
+    LIBTS_UNIT_CHECK(restored.max == hist.max);
+    LIBTS_UNIT_CHECK(restored.sum == hist.sum);
+    for (i = 0; i < hist.n_counts && i < restored.n_counts; i++)
+        LIBTS_UNIT_CHECK(restored.counts[i] == hist.counts[i]);
+
+    libts_histogram_free(&restored);
+    libts_histogram_free(&hist);
+
+    LIBTS_UNIT_CHECK(libts_histogram_from_str(&restored, "LTSH1 1") != 0);
+    LIBTS_UNIT_CHECK(libts_histogram_from_str(&restored,
+                                              "LTSH1 1000 3 1 1 1 0 x")
+                     != 0);
+    LIBTS_UNIT_CHECK(libts_histogram_from_str(&restored,
+                                              "LTSH1 1000 3 1 1 1 0 "
+                                              "100000:1") != 0);
+
+    te_string_free(&str);
+}
+
+int
+main(void)
+{
+    test_precision();
+    test_init_invalid();
+    test_percentiles();
+    test_merge();
+    test_serialization();
+
+    return libts_unit_result();
+}
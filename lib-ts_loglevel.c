@@ -0,0 +1,233 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Console loglevel windows API
+ *
+ * Implementation of console loglevel windows.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Loglevel"
+
+#include "lib-ts.h"
+#include "lib-ts_loglevel.h"
+
+/** Default console loglevel of a quiet window */
+#define QUIET_LOGLEVEL_DEF  1
+
+/** Current quiet window */
+static struct {
+    te_bool         opened;         /**< Whether a window is opened */
+    char           *name;           /**< Window name */
+    const char     *ta;             /**< IUT agent name */
+    te_bool         level_changed;  /**< Whether the loglevel is changed */
+    int             saved_level;    /**< Loglevel before the window */
+    te_bool         marked;         /**< Whether the begin mark is put to
+                                         the kernel log */
+    char            mark[64];       /**< Mark of the window in the kernel
+                                         log */
+    unsigned int    counter;        /**< Number of opened windows */
+    te_bool         atexit_set;     /**< Whether the exit handler is
+                                         registered */
+} window;
+
+/**
+ * Get console loglevel of quiet windows.
+ *
+ * @return Loglevel or @c -1 if it should not be changed.
+ */
+static int
+quiet_loglevel(void)
+{
+    const char *val = getenv("SFC_ONLOAD_QUIET_LOGLEVEL");
+    char       *end;
+    long        level;
+
+    if (val == NULL)
+        return QUIET_LOGLEVEL_DEF;
+    if (*val == '\0')
+        return -1;
+
+    level = strtol(val, &end, 0);
+    if (*end != '\0' || level < 0 || level > 15)
+    {
+        WARN("Invalid SFC_ONLOAD_QUIET_LOGLEVEL value '%s', use %d",
+             val, QUIET_LOGLEVEL_DEF);
+        return QUIET_LOGLEVEL_DEF;
+    }
+
+    return level;
+}
+
+/**
+ * End an opened window at the process exit, e.g. if a test failed
+ * before its cleanup ended the window.
+ */
+static void
+loglevel_atexit(void)
+{
+    if (window.opened)
+    {
+        WARN("Quiet window '%s' is not ended, end it at exit", window.name);
+        libts_loglevel_quiet_end(TRUE);
+    }
+}
+
+/* See description in lib-ts_loglevel.h */
+te_errno
+libts_loglevel_quiet_begin(const char *fmt, ...)
+{
+    te_string   name = TE_STRING_INIT;
+    int         level = quiet_loglevel();
+    va_list     ap;
+    te_errno    rc;
+
+    if (window.opened)
+    {
+        ERROR("Quiet window '%s' is already opened", window.name);
+        return TE_RC(TE_TAPI, TE_EALREADY);
+    }
+
+    window.ta = getenv("TE_IUT_TA_NAME");
+    if (window.ta == NULL)
+    {
+        ERROR("Cannot get IUT agent name");
+        return TE_RC(TE_TAPI, TE_ENOENT);
+    }
+
+    va_start(ap, fmt);
+    rc = te_string_append_va(&name, fmt, ap);
+    va_end(ap);
+    if (rc != 0)
+    {
+        te_string_free(&name);
+        return rc;
+    }
+
+    window.level_changed = FALSE;
+    if (level >= 0)
+    {
+        rc = tapi_cfg_get_loglevel(window.ta, &window.saved_level);
+        if (rc == 0)
+            rc = tapi_cfg_set_loglevel(window.ta, level);
+        if (rc != 0)
+        {
+            ERROR("Failed to set console loglevel %d on %s: %r", level,
+                  window.ta, rc);
+            te_string_free(&name);
+            return rc;
+        }
+        window.level_changed = TRUE;
+    }
+
+    /*
+     * The mark is written after the loglevel is lowered, so it is not
+     * printed to the console itself.
+     */
+    snprintf(window.mark, sizeof(window.mark), "libts-quiet-%d-%u",
+             (int)getpid(), ++window.counter);
+    rc = libts_ta_shell(window.ta, NULL, "echo '<6>%s begin' >/dev/kmsg",
+                        window.mark);
+    window.marked = (rc == 0);
+    if (rc != 0)
+    {
+        WARN("Failed to mark kernel log, messages of quiet window '%s' "
+             "will not be collected: %r", name.ptr, rc);
+    }
+
+    if (!window.atexit_set)
+    {
+        atexit(loglevel_atexit);
+        window.atexit_set = TRUE;
+    }
+
+    window.name = name.ptr;
+    window.opened = TRUE;
+
+    if (window.level_changed)
+    {
+        RING("Quiet window '%s' is begun, console loglevel %d -> %d",
+             window.name, window.saved_level, level);
+    }
+    else
+    {
+        RING("Quiet window '%s' is begun", window.name);
+    }
+
+    return 0;
+}
+
+/* See description in lib-ts_loglevel.h */
+te_errno
+libts_loglevel_quiet_end(te_bool failed)
+{
+    char       *out = NULL;
+    te_errno    rc = 0;
+    te_errno    rc2;
+
+    if (!window.opened)
+        return 0;
+    window.opened = FALSE;
+
+    if (window.marked)
+    {
+        rc2 = libts_ta_shell(window.ta, NULL,
+                             "echo '<6>%s end' >/dev/kmsg", window.mark);
+        if (rc2 != 0)
+            WARN("Failed to mark kernel log: %r", rc2);
+    }
+
+    if (window.level_changed)
+    {
+        rc = tapi_cfg_set_loglevel(window.ta, window.saved_level);
+        if (rc != 0)
+        {
+            ERROR("Failed to restore console loglevel %d on %s: %r",
+                  window.saved_level, window.ta, rc);
+        }
+    }
+
+    if (window.marked)
+    {
+        rc2 = libts_ta_shell_get(window.ta, &out,
+                "dmesg | awk -v b='%s begin' -v e='%s end' "
+                "'f && index($0, e) { exit } f { print } "
+                "index($0, b) { f = 1 } "
+                "END { if (!f) print \"(window start is not in the "
+                "kernel log anymore)\" }'",
+                window.mark, window.mark);
+        if (rc2 != 0)
+        {
+            ERROR("Failed to get kernel messages of quiet window '%s': %r",
+                  window.name, rc2);
+            if (rc == 0)
+                rc = rc2;
+        }
+        else if (out[0] == '\0')
+        {
+            RING("Quiet window '%s' is ended, no kernel messages",
+                 window.name);
+        }
+        else if (failed)
+        {
+            WARN("Quiet window '%s' is ended after a failure, kernel "
+                 "messages:\n%s", window.name, out);
+        }
+        else
+        {
+            RING("Quiet window '%s' is ended, kernel messages:\n%s",
+                 window.name, out);
+        }
+    }
+    else
+    {
+        RING("Quiet window '%s' is ended", window.name);
+    }
+
+    free(out);
+    free(window.name);
+    window.name = NULL;
+
+    return rc;
+}
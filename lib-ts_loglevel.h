@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Console loglevel windows API
+ *
+ * Quiet windows of IUT kernel console: the console loglevel is lowered
+ * while a measurement is done, so that printk output to a slow (serial)
+ * console does not stall CPUs, and restored when the window is ended.
+ * Kernel messages logged during the window are taken from the kernel
+ * log buffer and put to the test log.
+ *
+ * The loglevel of a window is specified by SFC_ONLOAD_QUIET_LOGLEVEL
+ * (1 by default). If it is set to an empty value, the loglevel is not
+ * changed, only kernel messages of the window are collected.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_LOGLEVEL_H__
+#define __ONLOAD_LIB_TS_LOGLEVEL_H__
+
+#include "te_errno.h"
+#include "te_defs.h"
+
+/**
+ * Begin a quiet window on IUT host. Windows cannot be nested.
+ * An opened window is ended automatically at the process exit.
+ *
+ * @param fmt       Format string of the window name.
+ * @param ...       Format string arguments.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_loglevel_quiet_begin(const char *fmt, ...)
+                                    __attribute__((format(printf, 1, 2)));
+
+/**
+ * End the current quiet window: restore the console loglevel and log
+ * kernel messages of the window. It does nothing if there is no
+ * opened window, so it can be called in cleanup unconditionally.
+ *
+ * @param failed    Whether the measurement done in the window failed
+ *                  (kernel messages are logged as a warning then).
+ *
+ * @return Status code.
+ */
+extern te_errno libts_loglevel_quiet_end(te_bool failed);
+
+#endif /* !__ONLOAD_LIB_TS_LOGLEVEL_H__ */
@@ -0,0 +1,139 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Memoization API unit test
+ *
+ * Checks of libts_memo_get(), libts_memo_set() and
+ * libts_memo_invalidate().
+ *
+ * @author agent <agent@local>
+ */
+
+#include <pthread.h>
+
+#include "lib-ts.h"
+#include "lib-ts_unit.h"
+
+DEFINE_LGR_ENTITY("libts_memo_test");
+
+/** Number of threads setting values concurrently */
+#define MEMO_THREADS 8
+
+/** Number of keys set by every thread */
+#define MEMO_KEYS 100
+
+/**
+ * Check that a key has the expected value.
+ *
+ * @param key       Key.
+ * @param expected  Expected value or @c NULL if there should be no value.
+ */
+static void
+check_value(const char *key, const char *expected)
+{
+    char       *value = NULL;
+    te_errno    rc;
+
+    rc = libts_memo_get(key, &value);
+    if (expected == NULL)
+    {
+        LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(rc) == TE_ENOENT);
+    }
+    else
+    {
+        LIBTS_UNIT_CHECK(rc == 0);
+        LIBTS_UNIT_CHECK(value != NULL && strcmp(value, expected) == 0);
+    }
+
+    free(value);
+}
+
+/**
+ * Check setting, replacing and dropping values.
+ */
+static void
+test_set_get(void)
+{
+    check_value("sfc_ta", NULL);
+
+    LIBTS_UNIT_CHECK(libts_memo_set("sfc_ta", "Agt_A") == 0);
+    LIBTS_UNIT_CHECK(libts_memo_set("ns_ta", "Agt_NS") == 0);
+    check_value("sfc_ta", "Agt_A");
+    check_value("ns_ta", "Agt_NS");
+    check_value("sfc", NULL);
+
+    LIBTS_UNIT_CHECK(libts_memo_set("sfc_ta", "Agt_B") == 0);
+    check_value("sfc_ta", "Agt_B");
+
+    libts_memo_invalidate();
+    check_value("sfc_ta", NULL);
+    check_value("ns_ta", NULL);
+
+    LIBTS_UNIT_CHECK(libts_memo_set("sfc_ta", "") == 0);
+    check_value("sfc_ta", "");
+    libts_memo_invalidate();
+}
+
+/**
+ * Set values of the thread keys.
+ *
+ * @param arg       Thread number.
+ *
+ * @return @c NULL.
+ */
+static void *
+memo_thread(void *arg)
+{
+    char            key[32];
+    unsigned int    i;
+
+    for (i = 0; i < MEMO_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key_%u_%u", *(unsigned int *)arg, i);
+        LIBTS_UNIT_CHECK(libts_memo_set(key, key) == 0);
+    }
+
+    return NULL;
+}
+
+/**
+ * Check that values set by concurrent threads are not lost.
+ */
+static void
+test_threads(void)
+{
+    pthread_t       threads[MEMO_THREADS];
+    unsigned int    ids[MEMO_THREADS];
+    char            key[32];
+    unsigned int    i;
+    unsigned int    j;
+
+    for (i = 0; i < MEMO_THREADS; i++)
+    {
+        ids[i] = i;
+        LIBTS_UNIT_CHECK(pthread_create(&threads[i], NULL, memo_thread,
+                                        &ids[i]) == 0);
+    }
+    for (i = 0; i < MEMO_THREADS; i++)
+        pthread_join(threads[i], NULL);
+
+    for (i = 0; i < MEMO_THREADS; i++)
+    {
+        for (j = 0; j < MEMO_KEYS; j++)
+        {
+            snprintf(key, sizeof(key), "key_%u_%u", i, j);
+            check_value(key, key);
+        }
+    }
+
+    libts_memo_invalidate();
+}
+
+int
+main(void)
+{
+    test_set_get();
+    test_threads();
+
+    return libts_unit_result();
+}
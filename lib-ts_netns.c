@@ -10,8 +10,14 @@
 
 #define TE_LGR_USER     "Libts Netns"
 
+#include <sys/file.h>
+#include <fcntl.h>
+#include <pthread.h>
+
 #include "lib-ts.h"
 #include "lib-ts_netns.h"
+#include "lib-ts_addrs.h"
+#include "lib-ts_timing.h"
 #include "tapi_cfg.h"
 #include "tapi_namespaces.h"
 #include "tapi_host_ns.h"
@@ -26,13 +32,95 @@
         }                                                               \
     } while(0)
 
+/**
+ * Get value of environment variable describing namespace @p _slot,
+ * return @c TE_ENOENT from the calling function if it is not set.
+ */
+#define NETNS_SLOT_GETENV(_var, _env, _slot)  \
+    do {                                                                \
+        _var = netns_getenv(_slot, _env);                               \
+        if (_var == NULL)                                               \
+        {                                                               \
+            ERROR("Environment variable %s is not specified for "       \
+                  "namespace %u", _env, _slot);                         \
+            return TE_RC(TE_TAPI, TE_ENOENT);                           \
+        }                                                               \
+    } while(0)
+
+/** Memoization key of the agent which controls SFC interfaces */
+#define MEMO_SFC_TA "netns.sfc_ta"
+/** Memoization key of the agent in the namespace */
+#define MEMO_NS_TA "netns.ns_ta"
+/** Memoization key prefix of the control interface */
+#define MEMO_CTL_IF "netns.ctl_if:"
+
+/** Location of namespace slot lock files on the engine host */
+#define NETNS_SLOT_LOCK_FMT "%s/libts_netns_slot_%u.lock"
+
+/** Interval of polling for a free namespace slot, ms */
+#define NETNS_SLOT_POLL_INTERVAL 100
+
+/** Namespace slot lock */
+typedef struct netns_slot_lock {
+    te_bool locked;     /**< Whether the slot is allocated by the process */
+    int     fd;         /**< Descriptor of the locked file */
+} netns_slot_lock;
+
+/** Locks of namespace slots */
+static netns_slot_lock netns_slot_locks[LIBTS_NETNS_SLOTS_MAX];
+
+/** Namespace slot the process works with */
+static unsigned int netns_slot_current = 0;
+
+/** Lock protecting @p netns_slot_locks and @p netns_slot_current */
+static pthread_mutex_t netns_slot_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Get value of environment variable describing a namespace slot.
+ * Variables of slot @c 0 have usual names, variables of other slots
+ * have the slot number suffix, e.g. TE_IUT_TA_NAME_NS_1.
+ *
+ * @param slot      Namespace slot
+ * @param name      Variable name
+ *
+ * @return Variable value or @c NULL
+ */
+static const char *
+netns_getenv(unsigned int slot, const char *name)
+{
+    char var[RCF_MAX_NAME];
+
+    if (slot == 0)
+        return getenv(name);
+
+    snprintf(var, sizeof(var), "%s_%u", name, slot);
+    return getenv(var);
+}
+
+/* See description in lib-ts_netns.h */
+const char *
+libts_netns_slot_getenv(const char *name)
+{
+    unsigned int slot;
+
+    pthread_mutex_lock(&netns_slot_mutex);
+    slot = netns_slot_current;
+    pthread_mutex_unlock(&netns_slot_mutex);
+
+    return netns_getenv(slot, name);
+}
+
+/* See description in lib-ts_netns.h */
 te_errno
 libts_netns_get_sfc_ta(char **ta)
 {
-    te_errno rc;
-    char     *if_name;
-    char     *agent;
-    int32_t  status;
+    te_errno    rc;
+    const char *if_name;
+    const char *agent;
+    int32_t     status;
+
+    if (libts_memo_get(MEMO_SFC_TA, ta) == 0)
+        return 0;
 
     agent = getenv("TE_IUT_TA_NAME");
     if (agent == NULL)
@@ -41,7 +129,7 @@ libts_netns_get_sfc_ta(char **ta)
         return TE_RC(TE_TAPI, te_rc_os2te(errno));
     }
 
-    if_name = getenv("TE_ORIG_IUT_TST1");
+    if_name = libts_netns_slot_getenv("TE_ORIG_IUT_TST1");
     if (if_name == NULL)
     {
         ERROR("Cannot get IUT interface name");
@@ -52,7 +140,7 @@ libts_netns_get_sfc_ta(char **ta)
                        agent, if_name);
     if (rc == TE_RC(TE_CS, TE_ENOENT))
     {
-        agent = getenv("TE_IUT_TA_NAME_NS");
+        agent = libts_netns_slot_getenv("TE_IUT_TA_NAME_NS");
         if (agent == NULL)
         {
             ERROR("Cannot get namespaced IUT agent name");
@@ -69,55 +157,280 @@ libts_netns_get_sfc_ta(char **ta)
     if (*ta == NULL)
         return TE_RC(TE_TAPI, TE_ENOMEM);
 
+    return libts_memo_set(MEMO_SFC_TA, agent);
+}
+
+/* See description in lib-ts_netns.h */
+te_errno
+libts_netns_get_ns_ta(char **ta)
+{
+    cfg_handle  handle;
+    char       *agent = NULL;
+    const char *name;
+    te_errno    rc;
+
+    /* Empty value means that there is no such agent */
+    if (libts_memo_get(MEMO_NS_TA, &agent) != 0)
+    {
+        name = libts_netns_slot_getenv("TE_IUT_TA_NAME_NS");
+        if (name != NULL)
+        {
+            rc = cfg_find_fmt(&handle, "/agent:%s", name);
+            if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
+                name = NULL;
+            else if (rc != 0)
+                return rc;
+        }
+
+        rc = libts_memo_set(MEMO_NS_TA, name == NULL ? "" : name);
+        if (rc != 0)
+            return rc;
+
+        agent = strdup(name == NULL ? "" : name);
+        if (agent == NULL)
+            return TE_RC(TE_TAPI, TE_ENOMEM);
+    }
+
+    if (agent[0] == '\0')
+    {
+        free(agent);
+        return TE_RC(TE_TAPI, TE_ENOENT);
+    }
+
+    *ta = agent;
+    return 0;
+}
+
+/** Maximum number of testing interfaces moved to the namespace */
+#define NETNS_IFS_MAX 5
+
+/**
+ * Get names of testing interfaces which should be moved to the namespace.
+ *
+ * @param slot      Namespace slot
+ * @param orig      Get original (the lowest) interfaces if @c TRUE
+ * @param ifs       Where to put interface names (at least
+ *                  @c NETNS_IFS_MAX elements)
+ *
+ * @return Number of interfaces
+ */
+static unsigned int
+get_iut_ifs(unsigned int slot, te_bool orig, const char **ifs)
+{
+    const char *iut_ifs[NETNS_IFS_MAX] = { "TE_IUT_TST1",
+                                           "TE_IUT_TST1_IUT",
+                                           "TE_IUT_TST1_IUT2",
+                                           "TE_IUT_TST1_IUT3",
+                                           "TE_IUT_TST2_TST"
+                                         };
+    const char *iut_ifs_orig[NETNS_IFS_MAX] = { "TE_ORIG_IUT_TST1",
+                                                "TE_ORIG_IUT_TST1_IUT",
+                                                "TE_ORIG_IUT_TST1_IUT2",
+                                                "TE_ORIG_IUT_TST1_IUT3",
+                                                "TE_ORIG_IUT_TST2_TST"
+                                              };
+    const char     *ifname;
+    unsigned int    n = 0;
+    size_t          i;
+
+    for (i = 0; i < NETNS_IFS_MAX; i++)
+    {
+        if (orig)
+            ifname = netns_getenv(slot, iut_ifs_orig[i]);
+        else
+            ifname = netns_getenv(slot, iut_ifs[i]);
+        if (ifname != NULL && strlen(ifname) > 0)
+            ifs[n++] = ifname;
+    }
+
+    return n;
+}
+
+/**
+ * Register testing interfaces moved to the namespace as resources of the
+ * agent in the namespace and in the host-ns tree.
+ *
+ * @param ns_ta     Agent name in the net namespace
+ * @param ifs       Testing interfaces
+ * @param n_ifs     Number of testing interfaces
+ *
+ * @return Status code
+ */
+static te_errno
+ns_interfaces_register(const char *ns_ta, const char **ifs,
+                       unsigned int n_ifs)
+{
+    te_errno        rc;
+    unsigned int    i;
+
+    for (i = 0; i < n_ifs; i++)
+    {
+        rc = tapi_cfg_base_if_add_rsrc(ns_ta, ifs[i]);
+        if (rc == 0)
+            rc = tapi_host_ns_if_add(ns_ta, ifs[i], NULL);
+        if (rc != 0)
+            return rc;
+    }
+
+    return 0;
+}
+
+/**
+ * Move testing interfaces to the namespace @p ns_name one by one.
+ *
+ * @param ta        Test agent
+ * @param ns_name   The namespace name
+ * @param ns_ta     Agent name in the net namespace
+ * @param ifs       Interfaces to move
+ * @param n_ifs     Number of interfaces
+ *
+ * @return Status code
+ */
+static te_errno
+move_interfaces_to_ns_serial(const char *ta, const char *ns_name,
+                             const char *ns_ta, const char **ifs,
+                             unsigned int n_ifs)
+{
+    te_errno        rc;
+    unsigned int    i;
+
+    for (i = 0; i < n_ifs; i++)
+    {
+        rc = tapi_host_ns_if_change_ns(ta, ifs[i], ns_name, ns_ta);
+        if (rc != 0)
+            return rc;
+    }
+
     return 0;
 }
 
 /**
  * Move testing interfaces to the namespace @p ns_name.
  *
+ * Instances /agent:<ta>/namespace:/net:<ns_name>/interface:<if> (which
+ * move interfaces as tapi_netns_if_set() does) are added for all
+ * interfaces locally and committed at once, and configurator is
+ * synchronized once after that. If anything fails, all interfaces are
+ * moved back by a single command on the agent and returned to the agent
+ * @p ta. Set @b SOCKAPI_TS_NETNS_IF_MOVE_SERIAL to @c TRUE to move
+ * interfaces one by one.
+ *
  * @param ta        Test agent
  * @param ns_name   The namespace name
  * @param ns_ta     Agent name in the net namespace
- * @param orig      Move original (the lowest) interfaces to the namespace
- *                  if @c TRUE
+ * @param ifs       Interfaces to move
+ * @param n_ifs     Number of interfaces
  *
  * @return Status code
  */
 static te_errno
 move_interfaces_to_ns(const char *ta, const char *ns_name, const char *ns_ta,
-                      te_bool orig)
+                      const char **ifs, unsigned int n_ifs)
 {
-    const char *iut_ifs[] = { "TE_IUT_TST1",
-                              "TE_IUT_TST1_IUT",
-                              "TE_IUT_TST1_IUT2",
-                              "TE_IUT_TST1_IUT3",
-                              "TE_IUT_TST2_TST"
-                            };
-    const char *iut_ifs_orig[] = { "TE_ORIG_IUT_TST1",
-                                   "TE_ORIG_IUT_TST1_IUT",
-                                   "TE_ORIG_IUT_TST1_IUT2",
-                                   "TE_ORIG_IUT_TST1_IUT3",
-                                   "TE_ORIG_IUT_TST2_TST"
-                                 };
-    char       *ifname;
-    te_errno    rc;
-    size_t      i;
+    te_string       list = TE_STRING_INIT_STATIC(RCF_MAX_PATH);
+    te_string       ns_q = TE_STRING_INIT_STATIC(RCF_MAX_PATH);
+    te_errno        rc = 0;
+    te_errno        rc2;
+    unsigned int    released;
+    unsigned int    unreg = 0;
+    unsigned int    i;
+
+    if (n_ifs == 0)
+        return 0;
 
-    for (i = 0; i < TE_ARRAY_LEN(iut_ifs); i++)
+    if (tapi_getenv_bool("SOCKAPI_TS_NETNS_IF_MOVE_SERIAL"))
+        return move_interfaces_to_ns_serial(ta, ns_name, ns_ta, ifs, n_ifs);
+
+    for (i = 0; rc == 0 && i < n_ifs; i++)
     {
-        if (orig)
-            ifname = getenv(iut_ifs_orig[i]);
-        else
-            ifname = getenv(iut_ifs[i]);
-        if (ifname != NULL && strlen(ifname) > 0)
+        rc = te_string_append(&list, " ");
+        if (rc == 0)
+            rc = libts_shell_quote(&list, ifs[i]);
+    }
+    if (rc == 0)
+        rc = libts_shell_quote(&ns_q, ns_name);
+    if (rc != 0)
+        return rc;
+
+    for (released = 0; released < n_ifs; released++)
+    {
+        rc = tapi_cfg_base_if_del_rsrc(ta, ifs[released]);
+        if (rc != 0)
+            goto rollback_rsrc;
+    }
+
+    for (i = 0; i < n_ifs; i++)
+    {
+        rc = cfg_add_instance_local_fmt(NULL, CVT_NONE, NULL,
+                                        "/agent:%s/namespace:/net:%s/"
+                                        "interface:%s", ta, ns_name,
+                                        ifs[i]);
+        if (rc != 0)
+            break;
+    }
+    if (rc == 0)
+        rc = cfg_commit_fmt("/agent:%s/namespace:/net:%s", ta, ns_name);
+    if (rc != 0)
+        goto rollback_move;
+
+    rc = cfg_synchronize_fmt(TRUE, "/agent:%s/interface:", ta);
+    if (rc == 0)
+        rc = cfg_synchronize_fmt(TRUE, "/agent:%s/interface:", ns_ta);
+    if (rc != 0)
+        goto rollback_move;
+
+    for (unreg = 0; unreg < n_ifs; unreg++)
+    {
+        rc = tapi_host_ns_if_del(ta, ifs[unreg], FALSE);
+        if (rc != 0 && TE_RC_GET_ERROR(rc) != TE_ENOENT)
+            goto rollback_move;
+    }
+
+    return ns_interfaces_register(ns_ta, ifs, n_ifs);
+
+rollback_move:
+    ERROR("Failed to move interfaces%s to namespace %s: %r, moving them "
+          "back", list.ptr, ns_name, rc);
+
+    /* Some interfaces may be not moved, so errors are ignored */
+    rc2 = libts_ta_shell(ta, NULL,
+                         "for i in%s; do "
+                         "ip -n %s link set dev $i netns 1 2>/dev/null; "
+                         "done; true",
+                         list.ptr, ns_q.ptr);
+    if (rc2 != 0)
+        ERROR("Failed to move interfaces%s back: %r", list.ptr, rc2);
+
+    rc2 = cfg_synchronize_fmt(TRUE, "/agent:%s/namespace:", ta);
+    if (rc2 == 0)
+        rc2 = cfg_synchronize_fmt(TRUE, "/agent:%s/interface:", ta);
+    if (rc2 == 0)
+        rc2 = cfg_synchronize_fmt(TRUE, "/agent:%s/interface:", ns_ta);
+    if (rc2 != 0)
+        ERROR("Failed to synchronize interfaces: %r", rc2);
+
+    while (unreg-- > 0)
+    {
+        rc2 = tapi_host_ns_if_add(ta, ifs[unreg], NULL);
+        if (rc2 != 0 && TE_RC_GET_ERROR(rc2) != TE_EEXIST)
         {
-            rc = tapi_host_ns_if_change_ns(ta, ifname, ns_name, ns_ta);
-            if (rc != 0)
-                return rc;
+            ERROR("Failed to return %s to host-ns tree of %s: %r",
+                  ifs[unreg], ta, rc2);
         }
     }
 
-    return 0;
+rollback_rsrc:
+    while (released-- > 0)
+    {
+        rc2 = tapi_cfg_base_if_add_rsrc(ta, ifs[released]);
+        if (rc2 != 0)
+        {
+            ERROR("Failed to grab %s back by %s: %r", ifs[released], ta,
+                  rc2);
+        }
+    }
+
+    return rc;
 }
 
 /**
@@ -136,17 +449,13 @@ add_local_network_route(const char *ta, const char *ta_iut, const char *veth1,
                         const char *veth2)
 {
     struct sockaddr_storage addr;
-    struct sockaddr_storage gw_addr;
 
     char           *local_net_env;
     char            local_net[RCF_MAX_ID];
     char           *ptr;
     int             prefix;
     te_errno        rc;
-    cfg_handle     *addresses;
-    char           *inst_name;
-    unsigned int    addr_num;
-    unsigned int    i;
+    libts_addrs     addrs;
 
     local_net_env = getenv("SOCKAPI_TS_LOCAL_NETWORK");
     if (local_net_env == NULL)
@@ -168,41 +477,27 @@ add_local_network_route(const char *ta, const char *ta_iut, const char *veth1,
     if (rc != 0)
         return rc;
 
-    rc = cfg_find_pattern_fmt(&addr_num, &addresses,
-                              "/agent:%s/interface:%s/net_addr:*", ta, veth1);
+    /*
+     * The interface is just created, so the kept snapshot does not have
+     * its addresses.
+     */
+    libts_addrs_invalidate();
+    rc = libts_addrs_get_first(ta, veth1, AF_INET, &addrs);
     if (rc != 0)
         return rc;
 
-    for (i = 0; i < addr_num; i++)
-    {
-        rc = cfg_get_inst_name(addresses[i], &inst_name);
-        if (rc != 0)
-        {
-            free(addresses);
-            return rc;
-        }
-
-        /* Skip IPv6 */
-        if (strchr(inst_name, ':') == NULL)
-            break;
-        free(inst_name);
-    }
-    free(addresses);
-    if (i == addr_num)
+    if (addrs.n_addrs == 0)
     {
         ERROR("Failed to get IP address of %s", veth1);
+        libts_addrs_free(&addrs);
         return TE_RC(TE_TAPI, TE_EFAULT);
     }
 
-    rc = te_sockaddr_str2h(inst_name, SA(&gw_addr));
-    free(inst_name);
-    if (rc != 0)
-        return rc;
-
     rc = tapi_cfg_add_route(ta_iut, AF_INET,
                             te_sockaddr_get_netaddr(SA(&addr)), prefix,
-                            te_sockaddr_get_netaddr(SA(&gw_addr)),
+                            te_sockaddr_get_netaddr(SA(&addrs.addrs[0].addr)),
                             veth2, NULL, 0, 0, 0, 0, 0, 0, NULL);
+    libts_addrs_free(&addrs);
 
     return rc;
 }
@@ -220,18 +515,25 @@ add_local_network_route(const char *ta, const char *ta_iut, const char *veth1,
 static te_errno
 get_ctl_if(const char *ta, char *ctl_if, size_t ctl_if_len)
 {
-    te_errno rc;
+    te_errno rc = 0;
     size_t   len;
     char    *ifname;
     te_bool  release = FALSE;
+    char     key[RCF_MAX_NAME + sizeof(MEMO_CTL_IF)];
 
     ifname = getenv("SOCKAPI_TS_NETNS_CTL_IF");
     if (ifname == NULL)
     {
-        rc = cfg_get_instance_fmt(NULL, &ifname,
-                                  "/agent:%s/ip4_rt_default_if:", ta);
-        if (rc != 0)
-            return rc;
+        snprintf(key, sizeof(key), MEMO_CTL_IF "%s", ta);
+        if (libts_memo_get(key, &ifname) != 0)
+        {
+            rc = cfg_get_instance_fmt(NULL, &ifname,
+                                      "/agent:%s/ip4_rt_default_if:", ta);
+            if (rc == 0)
+                rc = libts_memo_set(key, ifname);
+            if (rc != 0)
+                return rc;
+        }
         release = TRUE;
     }
 
@@ -250,8 +552,160 @@ get_ctl_if(const char *ta, char *ctl_if, size_t ctl_if_len)
     return rc;
 }
 
-te_errno
-libts_setup_namespace(libts_netns_conn_mode mode)
+/**
+ * Bind processes of the namespace, i.e. the agent and RPC servers it
+ * starts later, to CPUs of the NUMA node of the testing interfaces and
+ * migrate their memory to the node, so that memory allocated later is
+ * local to the node as well. The node is recorded in the agent
+ * environment as SF_TS_IUT_NUMA_NODE.
+ *
+ * It is done if @b SOCKAPI_TS_NETNS_NUMA is @c TRUE.
+ *
+ * @param ta        Test agent in the main namespace
+ * @param ns_name   The namespace name
+ * @param ta_iut    Agent name in the net namespace
+ * @param ifs       Testing interfaces moved to the namespace
+ * @param n_ifs     Number of testing interfaces
+ *
+ * @return Status code
+ */
+static te_errno
+netns_numa_bind(const char *ta, const char *ns_name, const char *ta_iut,
+                const char **ifs, unsigned int n_ifs)
+{
+    te_string       list = TE_STRING_INIT_STATIC(RCF_MAX_PATH);
+    char           *out = NULL;
+    char           *line;
+    char           *saveptr = NULL;
+    char            node_str[16];
+    int             node = -1;
+    int             if_node;
+    unsigned int    i;
+    te_errno        rc = 0;
+
+    if (!tapi_getenv_bool("SOCKAPI_TS_NETNS_NUMA") || n_ifs == 0)
+        return 0;
+
+    for (i = 0; rc == 0 && i < n_ifs; i++)
+        rc = te_string_append(&list, " %s", ifs[i]);
+    if (rc != 0)
+        return rc;
+
+    rc = libts_ta_shell_get(ta, &out,
+                            "for i in%s; do ip netns exec %s "
+                            "cat /sys/class/net/$i/device/numa_node "
+                            "2>/dev/null || echo -1; done",
+                            list.ptr, ns_name);
+    if (rc != 0)
+        return rc;
+
+    /* The node of the first interface (TE_IUT_TST1) is preferred */
+    for (i = 0, line = strtok_r(out, "\n", &saveptr);
+         i < n_ifs && line != NULL;
+         i++, line = strtok_r(NULL, "\n", &saveptr))
+    {
+        if_node = atoi(line);
+        if (node < 0)
+            node = if_node;
+        else if (if_node >= 0 && if_node != node)
+            WARN("Interface %s is on NUMA node %d, not %d", ifs[i],
+                 if_node, node);
+    }
+    free(out);
+    out = NULL;
+
+    if (node < 0)
+    {
+        RING("NUMA node of interfaces%s is unknown, the agent %s is not "
+             "bound", list.ptr, ta_iut);
+        return 0;
+    }
+
+    rc = libts_ta_shell_get(ta, &out,
+                            "c=$(cat /sys/devices/system/node/node%d/cpulist)"
+                            " || exit 1; m=$(command -v migratepages); "
+                            "for p in $(ip netns pids %s); do "
+                            "taskset -a -p -c $c $p >/dev/null || exit 1; "
+                            "test -z \"$m\" || $m $p all %d; done; "
+                            "echo \"CPUs $c\"; test -n \"$m\" || "
+                            "echo 'migratepages is not available'",
+                            node, ns_name, node);
+    if (rc != 0)
+    {
+        ERROR("Failed to bind namespace %s to NUMA node %d: %r", ns_name,
+              node, rc);
+        return rc;
+    }
+    RING("Processes of namespace %s are bound to NUMA node %d:\n%s",
+         ns_name, node, out);
+    free(out);
+
+    snprintf(node_str, sizeof(node_str), "%d", node);
+    return cfg_add_instance_fmt(NULL, CVT_STRING, node_str,
+                                "/agent:%s/env:SF_TS_IUT_NUMA_NODE", ta_iut);
+}
+
+/**
+ * Synchronize configurator DB after the test agent is added to the
+ * namespace. Only the new agent subtree is synchronized since the
+ * namespace, the control channel and the host-ns tree are created
+ * via configurator and are already known to it.
+ *
+ * If @b SOCKAPI_TS_NETNS_SYNC_VERIFY is @c TRUE, full synchronization
+ * is done after that to check that nothing is missed.
+ *
+ * @param ta_iut    Name of the agent in the namespace.
+ *
+ * @return Status code
+ */
+static te_errno
+sync_ns_agent(const char *ta_iut)
+{
+    char       *backup = NULL;
+    te_errno    rc;
+    te_errno    rc2;
+
+    rc = cfg_synchronize_fmt(TRUE, "/agent:%s", ta_iut);
+    if (rc != 0 || !tapi_getenv_bool("SOCKAPI_TS_NETNS_SYNC_VERIFY"))
+        return rc;
+
+    rc = cfg_create_backup(&backup);
+    if (rc != 0)
+        return rc;
+
+    rc = cfg_synchronize("/:", TRUE);
+    if (rc == 0)
+    {
+        rc = cfg_verify_backup(backup);
+        if (rc != 0)
+        {
+            ERROR("Configurator DB is changed by full synchronization "
+                  "after synchronization of /agent:%s: %r", ta_iut, rc);
+        }
+        else
+        {
+            RING("Synchronization of /agent:%s is equivalent to full "
+                 "synchronization", ta_iut);
+        }
+    }
+
+    rc2 = cfg_release_backup(&backup);
+    if (rc == 0)
+        rc = rc2;
+
+    return rc;
+}
+
+/**
+ * Setup network namespace and IUT ta.
+ *
+ * @param mode     Control communication channel mode.
+ * @param slot     Namespace slot.
+ *
+ * @return Status code
+ */
+static te_errno
+setup_namespace(libts_netns_conn_mode mode, unsigned int slot)
 {
     const char *set_netns = getenv("SOCKAPI_TS_NETNS");
     const char *ta;
@@ -267,6 +721,8 @@ libts_setup_namespace(libts_netns_conn_mode mode)
     const char *rcfport_str;
     const char *ld_preload;
     const char *ta_rpcprovider;
+    const char *ifs[NETNS_IFS_MAX];
+    unsigned int n_ifs;
     int         rcfport;
     char        addr[RCF_MAX_NAME] = {};
     char        ctl_if[IFNAMSIZ];
@@ -280,43 +736,56 @@ libts_setup_namespace(libts_netns_conn_mode mode)
     NETNS_GETENV(ta_rpcprovider, "SF_TS_IUT_RPCPROVIDER");
     NETNS_GETENV(ta_type, "TE_IUT_TA_TYPE");
     NETNS_GETENV(host, "TE_IUT");
-    NETNS_GETENV(ta_iut, "TE_IUT_TA_NAME_NS");
-    NETNS_GETENV(ns_name, "SOCKAPI_TS_NETNS_NAME");
-    NETNS_GETENV(cfg, "SOCKAPI_TS_CFG_DUT");
+    NETNS_SLOT_GETENV(ta_iut, "TE_IUT_TA_NAME_NS", slot);
+    NETNS_SLOT_GETENV(ns_name, "SOCKAPI_TS_NETNS_NAME", slot);
+    /* Additional namespaces may be used without specific configuration */
+    if (slot == 0)
+        NETNS_GETENV(cfg, "SOCKAPI_TS_CFG_DUT");
+    else
+        cfg = netns_getenv(slot, "SOCKAPI_TS_CFG_DUT");
     if (mode == LIBTS_NETNS_CONN_MACVLAN)
     {
-        NETNS_GETENV(macvlan, "SOCKAPI_TS_NETNS_MACVLAN");
+        NETNS_SLOT_GETENV(macvlan, "SOCKAPI_TS_NETNS_MACVLAN", slot);
     }
     else
     {
-        NETNS_GETENV(veth1, "SOCKAPI_TS_NETNS_VETH1");
-        NETNS_GETENV(veth2, "SOCKAPI_TS_NETNS_VETH2");
+        NETNS_SLOT_GETENV(veth1, "SOCKAPI_TS_NETNS_VETH1", slot);
+        NETNS_SLOT_GETENV(veth2, "SOCKAPI_TS_NETNS_VETH2", slot);
     }
-    NETNS_GETENV(rcfport_str, "SOCKAPI_TS_NETNS_PORT");
+    NETNS_SLOT_GETENV(rcfport_str, "SOCKAPI_TS_NETNS_PORT", slot);
     rcfport = atoi(rcfport_str);
-    cfg_ifs = getenv("SOCKAPI_TS_CFG_IFS");
+    cfg_ifs = netns_getenv(slot, "SOCKAPI_TS_CFG_IFS");
 
     rc = get_ctl_if(ta, ctl_if, sizeof(ctl_if));
     if (rc != 0)
         return rc;
 
+    n_ifs = get_iut_ifs(slot, cfg_ifs != NULL, ifs);
+    ld_preload = getenv("TE_IUT_LD_PRELOAD");
+
+    libts_timing_start("netns_create");
     if (mode == LIBTS_NETNS_CONN_MACVLAN)
         rc = tapi_netns_create_ns_with_macvlan(ta, ns_name, ctl_if, macvlan,
                                                addr, sizeof(addr));
     else
         rc = tapi_netns_create_ns_with_net_channel(ta, ns_name, veth1, veth2,
                                                    ctl_if, rcfport);
+    libts_timing_stop();
     if (rc != 0)
         return rc;
 
-    ld_preload = getenv("TE_IUT_LD_PRELOAD");
+    libts_timing_start("netns_add_ta");
     rc = tapi_netns_add_ta(host, ns_name, ta_iut, ta_type, rcfport, addr,
                            ld_preload, FALSE);
+    libts_timing_stop();
     if (rc != 0)
         return rc;
 
     /* Synchronize configurator DB after new test agent added */
-    CHECK_RC(rc = cfg_synchronize("/:", TRUE));
+    libts_timing_start("cfg_synchronize");
+    rc = sync_ns_agent(ta_iut);
+    libts_timing_stop();
+    CHECK_RC(rc);
 
     CHECK_RC(cfg_set_instance_fmt(CVT_STRING, ta_rpcprovider,
                                   "/agent:%s/rpcprovider:", ta_iut));
@@ -325,7 +794,19 @@ libts_setup_namespace(libts_netns_conn_mode mode)
     if (rc != 0)
         return rc;
 
-    rc = move_interfaces_to_ns(ta, ns_name, ta_iut, cfg_ifs != NULL);
+    libts_timing_start("netns_move_interfaces");
+    rc = move_interfaces_to_ns(ta, ns_name, ta_iut, ifs, n_ifs);
+    libts_timing_stop();
+    if (rc != 0)
+        return rc;
+
+    /*
+     * The agent cannot be started with binding, so it is bound before
+     * RPC servers are created.
+     */
+    libts_timing_start("netns_numa_bind");
+    rc = netns_numa_bind(ta, ns_name, ta_iut, ifs, n_ifs);
+    libts_timing_stop();
     if (rc != 0)
         return rc;
 
@@ -338,16 +819,32 @@ libts_setup_namespace(libts_netns_conn_mode mode)
 
     if (cfg_ifs != NULL)
     {
+        libts_timing_start("cfg_process_history:%s", cfg_ifs);
         rc = cfg_process_history(cfg_ifs, NULL);
+        libts_timing_stop();
         if (rc != 0)
             return rc;
     }
 
-    return cfg_process_history(cfg, NULL);
+    if (cfg != NULL)
+    {
+        libts_timing_start("cfg_process_history:%s", cfg);
+        rc = cfg_process_history(cfg, NULL);
+        libts_timing_stop();
+    }
+
+    return rc;
 }
 
-te_errno
-libts_cleanup_netns(void)
+/**
+ * Remove network namespace, auxiliary test agent and interfaces.
+ *
+ * @param slot     Namespace slot.
+ *
+ * @return Status code
+ */
+static te_errno
+cleanup_netns(unsigned int slot)
 {
     const char *set_netns = getenv("SOCKAPI_TS_NETNS");
     const char *ta_iut;
@@ -357,7 +854,7 @@ libts_cleanup_netns(void)
     if (set_netns == NULL || strcmp(set_netns, "true") != 0)
         return 0;
 
-    ta_iut = getenv("TE_IUT_TA_NAME_NS");
+    ta_iut = netns_getenv(slot, "TE_IUT_TA_NAME_NS");
     /* Remove test agent added in prologue and run in auxiliary network
      * namespace. */
     if (ta_iut != NULL)
@@ -368,11 +865,12 @@ libts_cleanup_netns(void)
     }
     else
     {
-        ERROR("Failed to get ns agent name from env TE_IUT_TA_NAME_NS");
+        ERROR("Failed to get ns agent name from env TE_IUT_TA_NAME_NS "
+              "for namespace %u", slot);
         rc = TE_RC(TE_TA, TE_ENOENT);
     }
 
-    macvlan = getenv("SOCKAPI_TS_NETNS_MACVLAN");
+    macvlan = netns_getenv(slot, "SOCKAPI_TS_NETNS_MACVLAN");
     if (macvlan != NULL)
     {
         const char *ta;
@@ -381,7 +879,7 @@ libts_cleanup_netns(void)
         te_errno    rc2;
 
         NETNS_GETENV(ta, "TE_IUT_TA_NAME");
-        NETNS_GETENV(ns, "SOCKAPI_TS_NETNS_NAME");
+        NETNS_SLOT_GETENV(ns, "SOCKAPI_TS_NETNS_NAME", slot);
         rc2 = get_ctl_if(ta, ctl_if, sizeof(ctl_if));
         if (rc2 != 0)
             return rc2;
@@ -397,3 +895,201 @@ libts_cleanup_netns(void)
     rc = cfg_synchronize_fmt(TRUE, "/agent:%s", ta_iut);
     return rc;
 }
+
+/* See description in lib-ts_netns.h */
+unsigned int
+libts_netns_slots_num(void)
+{
+    return libts_getenv_uint("SOCKAPI_TS_NETNS_NUM", 1,
+                             LIBTS_NETNS_SLOTS_MAX, 1);
+}
+
+/* See description in lib-ts_netns.h */
+te_errno
+libts_netns_slot_get_ta(unsigned int slot, char **ta)
+{
+    const char *agent;
+
+    if (slot >= libts_netns_slots_num())
+        return TE_RC(TE_TAPI, TE_EINVAL);
+
+    agent = netns_getenv(slot, "TE_IUT_TA_NAME_NS");
+    if (agent == NULL)
+        return TE_RC(TE_TAPI, TE_ENOENT);
+
+    *ta = strdup(agent);
+    if (*ta == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+
+    return 0;
+}
+
+/**
+ * Try to lock a namespace slot. Should be called under
+ * @p netns_slot_mutex.
+ *
+ * @param slot      Namespace slot
+ * @param locked    Set to @c TRUE if the slot is locked
+ *
+ * @return Status code
+ */
+static te_errno
+netns_slot_trylock(unsigned int slot, te_bool *locked)
+{
+    const char *dir = getenv("TE_TMP");
+    char        path[RCF_MAX_PATH];
+    int         fd;
+    te_errno    rc;
+
+    *locked = FALSE;
+    if (netns_slot_locks[slot].locked)
+        return 0;
+
+    snprintf(path, sizeof(path), NETNS_SLOT_LOCK_FMT,
+             dir == NULL ? "/tmp" : dir, slot);
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if (fd < 0)
+    {
+        rc = te_rc_os2te(errno);
+        ERROR("Failed to open namespace slot lock file %s: %r", path, rc);
+        return TE_RC(TE_TAPI, rc);
+    }
+
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+    {
+        /* The slot is allocated by another process */
+        if (errno == EWOULDBLOCK)
+        {
+            close(fd);
+            return 0;
+        }
+
+        rc = te_rc_os2te(errno);
+        close(fd);
+        ERROR("Failed to lock namespace slot lock file %s: %r", path, rc);
+        return TE_RC(TE_TAPI, rc);
+    }
+
+    netns_slot_locks[slot].locked = TRUE;
+    netns_slot_locks[slot].fd = fd;
+    *locked = TRUE;
+
+    return 0;
+}
+
+/* See description in lib-ts_netns.h */
+te_errno
+libts_netns_slot_alloc(unsigned int timeout, unsigned int *slot)
+{
+    unsigned int    n = libts_netns_slots_num();
+    unsigned int    waited = 0;
+    unsigned int    i;
+    te_bool         locked = FALSE;
+    te_errno        rc = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&netns_slot_mutex);
+        for (i = 0; i < n && rc == 0 && !locked; i++)
+        {
+            rc = netns_slot_trylock(i, &locked);
+            if (locked)
+            {
+                netns_slot_current = i;
+                *slot = i;
+            }
+        }
+        pthread_mutex_unlock(&netns_slot_mutex);
+
+        if (rc != 0)
+            return rc;
+
+        if (locked)
+        {
+            /* Derived facts depend on the current slot */
+            libts_memo_invalidate();
+            RING("Namespace slot %u is allocated", *slot);
+            return 0;
+        }
+
+        if (waited >= timeout)
+            break;
+        usleep(NETNS_SLOT_POLL_INTERVAL * 1000);
+        waited += NETNS_SLOT_POLL_INTERVAL;
+    }
+
+    ERROR("No free namespace slot among %u", n);
+    return TE_RC(TE_TAPI, TE_EBUSY);
+}
+
+/* See description in lib-ts_netns.h */
+te_errno
+libts_netns_slot_free(unsigned int slot)
+{
+    if (slot >= LIBTS_NETNS_SLOTS_MAX)
+        return TE_RC(TE_TAPI, TE_EINVAL);
+
+    pthread_mutex_lock(&netns_slot_mutex);
+    if (!netns_slot_locks[slot].locked)
+    {
+        pthread_mutex_unlock(&netns_slot_mutex);
+        ERROR("Namespace slot %u is not allocated", slot);
+        return TE_RC(TE_TAPI, TE_ENOENT);
+    }
+
+    /* Closing the file releases the lock */
+    close(netns_slot_locks[slot].fd);
+    netns_slot_locks[slot].locked = FALSE;
+    if (netns_slot_current == slot)
+        netns_slot_current = 0;
+    pthread_mutex_unlock(&netns_slot_mutex);
+
+    libts_memo_invalidate();
+    RING("Namespace slot %u is released", slot);
+
+    return 0;
+}
+
+/* See description in lib-ts_netns.h */
+te_errno
+libts_setup_namespace(libts_netns_conn_mode mode)
+{
+    unsigned int    n = libts_netns_slots_num();
+    unsigned int    slot;
+    te_errno        rc = 0;
+
+    /* Topology is changed, so derived facts should be found again */
+    libts_memo_invalidate();
+    libts_timing_start("netns_setup");
+    for (slot = 0; slot < n && rc == 0; slot++)
+    {
+        libts_timing_start("netns_setup:%u", slot);
+        rc = setup_namespace(mode, slot);
+        libts_timing_stop();
+    }
+    libts_timing_stop();
+    libts_memo_invalidate();
+
+    return rc;
+}
+
+/* See description in lib-ts_netns.h */
+te_errno
+libts_cleanup_netns(void)
+{
+    unsigned int    slot = libts_netns_slots_num();
+    te_errno        rc = 0;
+    te_errno        rc2;
+
+    libts_memo_invalidate();
+    /* Remove all namespaces even if removal of some of them fails */
+    while (slot-- > 0)
+    {
+        rc2 = cleanup_netns(slot);
+        if (rc == 0)
+            rc = rc2;
+    }
+    libts_memo_invalidate();
+
+    return rc;
+}
@@ -5,6 +5,17 @@
  *
  * Auxilliary functions to work with network namespaces.
  *
+ * Several IUT namespaces (slots) may be set up to run independent test
+ * iterations concurrently, their number is specified by
+ * SOCKAPI_TS_NETNS_NUM environment variable (@c 1 by default).
+ * Namespace @c 0 is described by the usual environment variables
+ * (TE_IUT_TA_NAME_NS, SOCKAPI_TS_NETNS_NAME, SOCKAPI_TS_NETNS_PORT,
+ * SOCKAPI_TS_NETNS_VETH1/VETH2 or SOCKAPI_TS_NETNS_MACVLAN, testing
+ * interfaces TE_IUT_TST1 etc. and configuration SOCKAPI_TS_CFG_DUT,
+ * SOCKAPI_TS_CFG_IFS), namespace @c N is described by the same
+ * variables with @c _N suffix, e.g. TE_IUT_TA_NAME_NS_1. Configuration
+ * files are optional for additional namespaces.
+ *
  * @author Andrey Dmitrov <Andrey.Dmitrov@oktetlabs.ru>
  */
 
@@ -13,6 +24,9 @@
 
 #include "te_errno.h"
 
+/** Maximum number of IUT namespaces */
+#define LIBTS_NETNS_SLOTS_MAX 32
+
 /**
  * Configuration options of TA-TEN communication channel.
  */
@@ -26,6 +40,9 @@ typedef enum {
 /**
  * Get name of the test agent which controls real SFC interfaces.
  *
+ * @note The result is memoized until the topology is changed by
+ *       libts_setup_namespace() or libts_cleanup_netns().
+ *
  * @param ta    The test agent name (from the heap).
  *
  * @return Status code
@@ -33,7 +50,79 @@ typedef enum {
 extern te_errno libts_netns_get_sfc_ta(char **ta);
 
 /**
- * Setup network namespace and IUT ta.
+ * Get name of the IUT test agent running in the network namespace.
+ *
+ * @note The result is memoized until the topology is changed by
+ *       libts_setup_namespace() or libts_cleanup_netns().
+ *
+ * @param ta    The test agent name (from the heap).
+ *
+ * @return Status code (@c TE_ENOENT if there is no such agent)
+ */
+extern te_errno libts_netns_get_ns_ta(char **ta);
+
+/**
+ * Get number of IUT namespaces.
+ *
+ * @return Number of namespaces.
+ */
+extern unsigned int libts_netns_slots_num(void);
+
+/**
+ * Get name of the test agent running in an IUT namespace.
+ *
+ * @param slot  Namespace slot.
+ * @param ta    The test agent name (from the heap).
+ *
+ * @return Status code
+ */
+extern te_errno libts_netns_slot_get_ta(unsigned int slot, char **ta);
+
+/**
+ * Allocate an IUT namespace for exclusive use by the calling process.
+ * Slots are locked with files in TE_TMP directory on the engine host,
+ * so processes running concurrently get different slots, and the slot
+ * is released when the process exits.
+ *
+ * The allocated slot becomes the current one of the process: functions
+ * of this API and libts_netns_slot_getenv() use its agent and
+ * interfaces.
+ *
+ * @param timeout   How long to wait for a free slot, ms.
+ * @param slot      Where to put the allocated slot.
+ *
+ * @return Status code (@c TE_EBUSY if there is no free slot).
+ */
+extern te_errno libts_netns_slot_alloc(unsigned int timeout,
+                                       unsigned int *slot);
+
+/**
+ * Release an IUT namespace allocated by libts_netns_slot_alloc().
+ *
+ * @param slot  Namespace slot.
+ *
+ * @return Status code
+ */
+extern te_errno libts_netns_slot_free(unsigned int slot);
+
+/**
+ * Get value of environment variable describing the current IUT
+ * namespace of the process, e.g. TE_IUT_TST1 of the allocated slot.
+ *
+ * @param name  Variable name without slot suffix.
+ *
+ * @return Variable value or @c NULL.
+ */
+extern const char *libts_netns_slot_getenv(const char *name);
+
+/**
+ * Setup network namespace and IUT ta. All IUT namespaces are set up,
+ * see libts_netns_slots_num().
+ *
+ * @note If SOCKAPI_TS_NETNS_NUMA environment variable is set to
+ *       @c TRUE, the namespace agent is bound to CPUs and memory of the
+ *       NUMA node of the moved interfaces, the node is recorded to
+ *       /agent:<ns agent>/env:SF_TS_IUT_NUMA_NODE.
  *
  * @param mode     Control communication channel mode.
  *
@@ -42,7 +131,8 @@ extern te_errno libts_netns_get_sfc_ta(char **ta);
 extern te_errno libts_setup_namespace(libts_netns_conn_mode mode);
 
 /**
- * Remove network namespace, auxiliary test agent and interfaces.
+ * Remove network namespace, auxiliary test agent and interfaces. All IUT
+ * namespaces are removed.
  *
  * @return Status code
  */
@@ -0,0 +1,491 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Performance results store API
+ *
+ * Implementation of performance results store.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Results"
+
+#include <math.h>
+#include <stdio.h>
+#include <sys/file.h>
+#include <time.h>
+
+#include "lib-ts.h"
+#include "lib-ts_results.h"
+
+/** Sample with its origin for ranking */
+typedef struct results_rank {
+    double  value;      /**< Sample value */
+    te_bool current;    /**< Whether the sample is a current one */
+} results_rank;
+
+/**
+ * Get path of the store.
+ *
+ * @return Path or @c NULL if the store is not used.
+ */
+static const char *
+results_path(void)
+{
+    const char *path = getenv("SFC_ONLOAD_RESULTS");
+
+    return (path == NULL || path[0] == '\0') ? NULL : path;
+}
+
+/**
+ * Append a field of a line replacing tabs and line feeds with spaces.
+ *
+ * @param str       Where to append.
+ * @param s         Field value.
+ *
+ * @return Status code.
+ */
+static te_errno
+results_field_append(te_string *str, const char *s)
+{
+    size_t      start = str->len;
+    te_errno    rc;
+
+    rc = te_string_append(str, "%s\t", s == NULL ? "" : s);
+    if (rc != 0)
+        return rc;
+
+    for (; start < str->len - 1; start++)
+    {
+        if (str->ptr[start] == '\t' || str->ptr[start] == '\n')
+            str->ptr[start] = ' ';
+    }
+
+    return 0;
+}
+
+/**
+ * Append fields of a key and a metric.
+ *
+ * @param key       Key.
+ * @param metric    Metric name.
+ * @param str       Where to append.
+ *
+ * @return Status code.
+ */
+static te_errno
+results_key_append(const libts_results_key *key, const char *metric,
+                   te_string *str)
+{
+    te_errno rc;
+
+    rc = results_field_append(str, key->test);
+    if (rc == 0)
+        rc = results_field_append(str, key->params);
+    if (rc == 0)
+        rc = results_field_append(str, key->build);
+    if (rc == 0)
+        rc = results_field_append(str, key->host);
+    if (rc == 0)
+        rc = results_field_append(str, metric);
+
+    return rc;
+}
+
+/* See description in lib-ts_results.h */
+void
+libts_results_key_init(libts_results_key *key, const char *test,
+                       const char *params)
+{
+    key->test = test;
+    key->params = params;
+
+    key->build = getenv("SFC_ONLOAD_BUILD");
+    if (key->build == NULL || key->build[0] == '\0')
+        key->build = "unknown";
+
+    key->host = getenv("TE_IUT");
+    if (key->host == NULL || key->host[0] == '\0')
+        key->host = "unknown";
+}
+
+/* See description in lib-ts_results.h */
+te_errno
+libts_results_add(const libts_results_key *key, const char *metric,
+                  const double *values, unsigned int n_values)
+{
+    const char     *path = results_path();
+    te_string       prefix = TE_STRING_INIT;
+    te_string       lines = TE_STRING_INIT;
+    unsigned int    i;
+    FILE           *f;
+    te_errno        rc;
+
+    if (path == NULL)
+        return 0;
+
+    rc = te_string_append(&prefix, "%ld\t", (long)time(NULL));
+    if (rc == 0)
+        rc = results_key_append(key, metric, &prefix);
+    for (i = 0; i < n_values && rc == 0; i++)
+        rc = te_string_append(&lines, "%s%.17g\n", prefix.ptr, values[i]);
+    te_string_free(&prefix);
+    if (rc != 0)
+    {
+        te_string_free(&lines);
+        return rc;
+    }
+
+    f = fopen(path, "a");
+    if (f == NULL)
+    {
+        rc = TE_RC(TE_TAPI, te_rc_os2te(errno));
+        ERROR("Failed to open results store %s: %r", path, rc);
+        te_string_free(&lines);
+        return rc;
+    }
+
+    /* Lines of concurrent processes should not be interleaved */
+    if (flock(fileno(f), LOCK_EX) != 0 ||
+        (lines.len > 0 && fwrite(lines.ptr, lines.len, 1, f) != 1) ||
+        fflush(f) != 0)
+    {
+        rc = TE_RC(TE_TAPI, te_rc_os2te(errno));
+        ERROR("Failed to write results store %s: %r", path, rc);
+    }
+    fclose(f);
+
+    te_string_free(&lines);
+    return rc;
+}
+
+/* See description in lib-ts_results.h */
+te_errno
+libts_results_load(const libts_results_key *key, const char *metric,
+                   double **values, unsigned int *n_values)
+{
+    const char     *path = results_path();
+    te_string       match = TE_STRING_INIT;
+    char           *line = NULL;
+    size_t          line_size = 0;
+    char           *p;
+    char           *end;
+    double         *vals = NULL;
+    double         *tmp;
+    unsigned int    n = 0;
+    unsigned int    max = 0;
+    double          value;
+    FILE           *f;
+    te_errno        rc;
+
+    *values = NULL;
+    *n_values = 0;
+
+    if (path == NULL)
+        return TE_RC(TE_TAPI, TE_ENOENT);
+
+    rc = results_key_append(key, metric, &match);
+    if (rc != 0)
+        return rc;
+
+    f = fopen(path, "r");
+    if (f == NULL)
+    {
+        rc = TE_RC(TE_TAPI, te_rc_os2te(errno));
+        te_string_free(&match);
+        return rc;
+    }
+    flock(fileno(f), LOCK_SH);
+
+    while (rc == 0 && getline(&line, &line_size, f) >= 0)
+    {
+        /* Skip the time field and compare the key fields as a whole */
+        p = strchr(line, '\t');
+        if (p == NULL || strncmp(p + 1, match.ptr, match.len) != 0)
+            continue;
+        p += 1 + match.len;
+
+        value = strtod(p, &end);
+        if (end == p || (*end != '\n' && *end != '\0'))
+        {
+            WARN("Invalid line in results store %s: %s", path, line);
+            continue;
+        }
+
+        if (n == max)
+        {
+            max = max == 0 ? 32 : max * 2;
+            tmp = realloc(vals, max * sizeof(*vals));
+            if (tmp == NULL)
+            {
+                rc = TE_RC(TE_TAPI, TE_ENOMEM);
+                break;
+            }
+            vals = tmp;
+        }
+        vals[n++] = value;
+    }
+
+    fclose(f);
+    free(line);
+    te_string_free(&match);
+
+    if (rc != 0)
+    {
+        free(vals);
+        return rc;
+    }
+
+    *values = vals;
+    *n_values = n;
+    return 0;
+}
+
+/**
+ * Compare two doubles for qsort().
+ *
+ * @param a     The first value.
+ * @param b     The second value.
+ *
+ * @return Comparison result.
+ */
+static int
+double_cmp(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * Compare ranked samples for qsort().
+ *
+ * @param a     The first sample.
+ * @param b     The second sample.
+ *
+ * @return Comparison result.
+ */
+static int
+rank_cmp(const void *a, const void *b)
+{
+    return double_cmp(&((const results_rank *)a)->value,
+                      &((const results_rank *)b)->value);
+}
+
+/**
+ * Get median of samples.
+ *
+ * @param values    Samples.
+ * @param n         Number of samples (not zero).
+ * @param median    Where to put the median.
+ *
+ * @return Status code.
+ */
+static te_errno
+results_median(const double *values, unsigned int n, double *median)
+{
+    double *sorted = malloc(n * sizeof(*sorted));
+
+    if (sorted == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+
+    memcpy(sorted, values, n * sizeof(*sorted));
+    qsort(sorted, n, sizeof(*sorted), double_cmp);
+    *median = n % 2 == 1 ? sorted[n / 2] :
+                           (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    free(sorted);
+
+    return 0;
+}
+
+/* See description in lib-ts_results.h */
+te_errno
+libts_results_compare(const double *baseline, unsigned int n_baseline,
+                      const double *current, unsigned int n_current,
+                      te_bool higher_better, double alpha,
+                      libts_results_cmp *cmp)
+{
+    results_rank   *all;
+    unsigned int    n = n_baseline + n_current;
+    unsigned int    i;
+    unsigned int    j;
+    double          rank;
+    double          rank_sum = 0;
+    double          ties = 0;
+    double          t;
+    double          u;
+    double          mean;
+    double          sigma;
+    double          z;
+    te_errno        rc;
+
+    memset(cmp, 0, sizeof(*cmp));
+    cmp->n_baseline = n_baseline;
+    cmp->n_current = n_current;
+    cmp->p_value = 1;
+
+    if (n_baseline == 0 || n_current == 0)
+        return TE_RC(TE_TAPI, TE_EINVAL);
+
+    rc = results_median(baseline, n_baseline, &cmp->median_baseline);
+    if (rc == 0)
+        rc = results_median(current, n_current, &cmp->median_current);
+    if (rc != 0)
+        return rc;
+    if (cmp->median_baseline != 0)
+    {
+        cmp->change = 100. * (cmp->median_current - cmp->median_baseline) /
+                      fabs(cmp->median_baseline);
+    }
+
+    if (n_baseline < LIBTS_RESULTS_MIN_SAMPLES ||
+        n_current < LIBTS_RESULTS_MIN_SAMPLES)
+        return 0;
+
+    all = malloc(n * sizeof(*all));
+    if (all == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+    for (i = 0; i < n_baseline; i++)
+    {
+        all[i].value = baseline[i];
+        all[i].current = FALSE;
+    }
+    for (i = 0; i < n_current; i++)
+    {
+        all[n_baseline + i].value = current[i];
+        all[n_baseline + i].current = TRUE;
+    }
+    qsort(all, n, sizeof(*all), rank_cmp);
+
+    /* Tied samples get the average of their ranks */
+    for (i = 0; i < n; i = j)
+    {
+        for (j = i + 1; j < n && all[j].value == all[i].value; j++)
+            ;
+
+        t = j - i;
+        ties += t * t * t - t;
+        rank = (i + 1 + j) / 2.;
+        for (; i < j; i++)
+        {
+            if (all[i].current)
+                rank_sum += rank;
+        }
+    }
+    free(all);
+
+    u = rank_sum - n_current * (n_current + 1) / 2.;
+    mean = (double)n_baseline * n_current / 2;
+    sigma = sqrt((double)n_baseline * n_current / 12 *
+                 ((n + 1) - ties / ((double)n * (n - 1))));
+    if (sigma == 0)
+        return 0;
+
+    /*
+     * Small U means the current samples tend to be lower than the
+     * baseline ones. The continuity correction is towards the mean.
+     */
+    if (higher_better)
+    {
+        z = (u - mean + 0.5) / sigma;
+        cmp->p_value = 0.5 * erfc(-z / M_SQRT2);
+    }
+    else
+    {
+        z = (u - mean - 0.5) / sigma;
+        cmp->p_value = 0.5 * erfc(z / M_SQRT2);
+    }
+    cmp->regressed = cmp->p_value < alpha;
+
+    return 0;
+}
+
+/**
+ * Get significance level of regression check.
+ *
+ * @return Significance level.
+ */
+static double
+results_alpha(void)
+{
+    const char *val = getenv("SFC_ONLOAD_RESULTS_ALPHA");
+    char       *end;
+    double      alpha;
+
+    if (val == NULL || *val == '\0')
+        return LIBTS_RESULTS_ALPHA_DEF;
+
+    alpha = strtod(val, &end);
+    if (*end != '\0' || alpha <= 0 || alpha >= 1)
+    {
+        WARN("Invalid SFC_ONLOAD_RESULTS_ALPHA value '%s', use %g",
+             val, LIBTS_RESULTS_ALPHA_DEF);
+        return LIBTS_RESULTS_ALPHA_DEF;
+    }
+
+    return alpha;
+}
+
+/* See description in lib-ts_results.h */
+te_errno
+libts_results_check_regression(const libts_results_key *key,
+                               const char *baseline, const char *metric,
+                               const double *values, unsigned int n_values,
+                               te_bool higher_better,
+                               libts_results_cmp *cmp)
+{
+    libts_results_key   base_key = *key;
+    double             *base_values = NULL;
+    unsigned int        n_base = 0;
+    te_errno            rc;
+
+    memset(cmp, 0, sizeof(*cmp));
+
+    if (baseline == NULL)
+        baseline = getenv("SFC_ONLOAD_BASELINE_BUILD");
+    if (baseline == NULL || baseline[0] == '\0')
+        return TE_RC(TE_TAPI, TE_ENOENT);
+
+    base_key.build = baseline;
+    rc = libts_results_load(&base_key, metric, &base_values, &n_base);
+    if (rc == 0 && n_base == 0)
+        rc = TE_RC(TE_TAPI, TE_ENOENT);
+    if (rc != 0)
+    {
+        WARN("No baseline samples of %s of %s (%s) for build %s: %r",
+             metric, key->test, key->params, baseline, rc);
+        free(base_values);
+        return rc;
+    }
+
+    rc = libts_results_compare(base_values, n_base, values, n_values,
+                               higher_better, results_alpha(), cmp);
+    free(base_values);
+    if (rc != 0)
+        return rc;
+
+    if (n_base < LIBTS_RESULTS_MIN_SAMPLES ||
+        n_values < LIBTS_RESULTS_MIN_SAMPLES)
+    {
+        WARN("Too few samples of %s to check regression: %u of build %s, "
+             "%u of build %s", metric, n_base, baseline, n_values,
+             key->build);
+    }
+    else if (cmp->regressed)
+    {
+        WARN("Regression of %s of %s (%s): median %g of build %s, %g of "
+             "build %s (%+.1f%%), p-value %.4f", metric, key->test,
+             key->params, cmp->median_baseline, baseline,
+             cmp->median_current, key->build, cmp->change, cmp->p_value);
+    }
+    else
+    {
+        RING("No regression of %s of %s (%s): median %g of build %s, %g "
+             "of build %s (%+.1f%%), p-value %.4f", metric, key->test,
+             key->params, cmp->median_baseline, baseline,
+             cmp->median_current, key->build, cmp->change, cmp->p_value);
+    }
+
+    return 0;
+}
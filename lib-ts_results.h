@@ -0,0 +1,143 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Performance results store API
+ *
+ * Local store of performance measurement samples and comparison of
+ * samples with a baseline, e.g. results of another Onload build.
+ *
+ * The store is an append-only text file on the engine host specified
+ * by SFC_ONLOAD_RESULTS environment variable, with a line per sample:
+ * time, test, parameters, build, host, metric and value separated by
+ * tabs. Processes running concurrently append to it under a file lock.
+ * If the variable is not set, samples are not stored.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_RESULTS_H__
+#define __ONLOAD_LIB_TS_RESULTS_H__
+
+#include "te_errno.h"
+#include "te_defs.h"
+
+/** Default significance level of regression check */
+#define LIBTS_RESULTS_ALPHA_DEF 0.05
+/** Minimum number of samples on each side to check regression */
+#define LIBTS_RESULTS_MIN_SAMPLES 5
+
+/** Key of results */
+typedef struct libts_results_key {
+    const char *test;       /**< Test name */
+    const char *params;     /**< Test parameters, e.g. "size=1400" */
+    const char *build;      /**< Socket library build */
+    const char *host;       /**< IUT host */
+} libts_results_key;
+
+/** Result of comparison with a baseline */
+typedef struct libts_results_cmp {
+    unsigned int    n_baseline;         /**< Number of baseline samples */
+    unsigned int    n_current;          /**< Number of current samples */
+    double          median_baseline;    /**< Median of baseline samples */
+    double          median_current;     /**< Median of current samples */
+    double          change;             /**< Relative change of the
+                                             median, % */
+    double          p_value;            /**< One-sided p-value of the
+                                             Mann-Whitney U test that the
+                                             current samples are worse */
+    te_bool         regressed;          /**< Whether @a p_value is below
+                                             the significance level */
+} libts_results_cmp;
+
+/**
+ * Initialize key of results of the current run: the build is taken
+ * from SFC_ONLOAD_BUILD environment variable and the host from TE_IUT
+ * ("unknown" if they are not set).
+ *
+ * @param key       Key to initialize.
+ * @param test      Test name.
+ * @param params    Test parameters.
+ */
+extern void libts_results_key_init(libts_results_key *key,
+                                   const char *test, const char *params);
+
+/**
+ * Append samples of a metric to the store.
+ *
+ * @param key       Key of the samples.
+ * @param metric    Metric name, e.g. "latency_ns".
+ * @param values    Samples.
+ * @param n_values  Number of samples.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_results_add(const libts_results_key *key,
+                                  const char *metric, const double *values,
+                                  unsigned int n_values);
+
+/**
+ * Load stored samples of a metric.
+ *
+ * @param key       Key of the samples.
+ * @param metric    Metric name.
+ * @param values    Where to put the samples (from the heap).
+ * @param n_values  Where to put number of samples.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_results_load(const libts_results_key *key,
+                                   const char *metric, double **values,
+                                   unsigned int *n_values);
+
+/**
+ * Compare samples with baseline samples using one-sided Mann-Whitney
+ * U test (normal approximation with ties correction). If there are
+ * less than @c LIBTS_RESULTS_MIN_SAMPLES samples on a side, regression
+ * is never reported.
+ *
+ * @param baseline      Baseline samples.
+ * @param n_baseline    Number of baseline samples.
+ * @param current       Current samples.
+ * @param n_current     Number of current samples.
+ * @param higher_better Whether higher values are better (throughput),
+ *                      otherwise lower ones are (latency).
+ * @param alpha         Significance level.
+ * @param cmp           Where to put the comparison result.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_results_compare(const double *baseline,
+                                      unsigned int n_baseline,
+                                      const double *current,
+                                      unsigned int n_current,
+                                      te_bool higher_better, double alpha,
+                                      libts_results_cmp *cmp);
+
+/**
+ * Compare samples of the current run with stored samples of the same
+ * test, parameters and host of a baseline build and log the result.
+ * The significance level is taken from SFC_ONLOAD_RESULTS_ALPHA
+ * environment variable (@c LIBTS_RESULTS_ALPHA_DEF by default).
+ *
+ * @param key           Key of the current samples.
+ * @param baseline      Baseline build or @c NULL to take it from
+ *                      SFC_ONLOAD_BASELINE_BUILD environment variable.
+ * @param metric        Metric name.
+ * @param values        Current samples.
+ * @param n_values      Number of current samples.
+ * @param higher_better Whether higher values are better.
+ * @param cmp           Where to put the comparison result.
+ *
+ * @return Status code (@c TE_ENOENT if the baseline is not specified
+ *         or has no samples).
+ */
+extern te_errno libts_results_check_regression(
+                                    const libts_results_key *key,
+                                    const char *baseline,
+                                    const char *metric,
+                                    const double *values,
+                                    unsigned int n_values,
+                                    te_bool higher_better,
+                                    libts_results_cmp *cmp);
+
+#endif /* !__ONLOAD_LIB_TS_RESULTS_H__ */
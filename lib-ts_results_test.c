@@ -0,0 +1,202 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Performance results store API unit test
+ *
+ * Checks of the Mann-Whitney U test against reference p-values, of
+ * the store in a temporary file and of regression checks with it.
+ *
+ * @author agent <agent@local>
+ */
+
+#include "lib-ts.h"
+#include "lib-ts_results.h"
+#include "lib-ts_unit.h"
+
+DEFINE_LGR_ENTITY("libts_results_test");
+
+/** Tolerance of p-values */
+#define P_EPS 1e-9
+
+/**
+ * Check comparison of fully separated samples in both directions.
+ */
+static void
+test_compare_separated(void)
+{
+    static const double base[] = { 14, 10, 12, 11, 13 };
+    static const double cur[] = { 20, 24, 21, 23, 22 };
+    libts_results_cmp   cmp;
+
+    /* Latency has grown */
+    LIBTS_UNIT_CHECK(libts_results_compare(base, TE_ARRAY_LEN(base),
+                                           cur, TE_ARRAY_LEN(cur),
+                                           FALSE, 0.05, &cmp) == 0);
+    LIBTS_UNIT_CHECK(cmp.n_baseline == 5 && cmp.n_current == 5);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.median_baseline, 12, P_EPS);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.median_current, 22, P_EPS);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.change, 250. / 3, P_EPS);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.p_value, 0.006092890177672409, P_EPS);
+    LIBTS_UNIT_CHECK(cmp.regressed);
+
+    /* Throughput has grown */
+    LIBTS_UNIT_CHECK(libts_results_compare(base, TE_ARRAY_LEN(base),
+                                           cur, TE_ARRAY_LEN(cur),
+                                           TRUE, 0.05, &cmp) == 0);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.p_value, 0.9966923245172357, P_EPS);
+    LIBTS_UNIT_CHECK(!cmp.regressed);
+
+    /* Significance level is respected */
+    LIBTS_UNIT_CHECK(libts_results_compare(base, TE_ARRAY_LEN(base),
+                                           cur, TE_ARRAY_LEN(cur),
+                                           FALSE, 0.005, &cmp) == 0);
+    LIBTS_UNIT_CHECK(!cmp.regressed);
+}
+
+/**
+ * Check comparison of samples with ties.
+ */
+static void
+test_compare_ties(void)
+{
+    static const double base5[] = { 1, 2, 2, 3, 3 };
+    static const double cur5[] = { 3, 4, 4, 5, 5 };
+    static const double base6[] = { 1, 2, 2, 3, 3, 4 };
+    static const double cur6[] = { 2, 3, 3, 4, 5, 5 };
+    static const double same[] = { 7, 7, 7, 7, 7 };
+    libts_results_cmp   cmp;
+
+    LIBTS_UNIT_CHECK(libts_results_compare(base5, TE_ARRAY_LEN(base5),
+                                           cur5, TE_ARRAY_LEN(cur5),
+                                           FALSE, 0.05, &cmp) == 0);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.p_value, 0.009432837192081843, P_EPS);
+    LIBTS_UNIT_CHECK(cmp.regressed);
+
+    LIBTS_UNIT_CHECK(libts_results_compare(base6, TE_ARRAY_LEN(base6),
+                                           cur6, TE_ARRAY_LEN(cur6),
+                                           FALSE, 0.05, &cmp) == 0);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.median_baseline, 2.5, P_EPS);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.median_current, 3.5, P_EPS);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.p_value, 0.0690053687843298, P_EPS);
+    LIBTS_UNIT_CHECK(!cmp.regressed);
+
+    LIBTS_UNIT_CHECK(libts_results_compare(base6, TE_ARRAY_LEN(base6),
+                                           cur6, TE_ARRAY_LEN(cur6),
+                                           TRUE, 0.05, &cmp) == 0);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.p_value, 0.9503281898707788, P_EPS);
+
+    /* All samples are tied, so there is no difference */
+    LIBTS_UNIT_CHECK(libts_results_compare(same, TE_ARRAY_LEN(same),
+                                           same, TE_ARRAY_LEN(same),
+                                           FALSE, 0.05, &cmp) == 0);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.p_value, 1, P_EPS);
+    LIBTS_UNIT_CHECK(!cmp.regressed);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.change, 0, P_EPS);
+}
+
+/**
+ * Check that regression is not reported with too few samples and that
+ * empty samples are rejected.
+ */
+static void
+test_compare_few(void)
+{
+    static const double base[] = { 10, 11, 12, 13 };
+    static const double cur[] = { 100, 101, 102, 103, 104 };
+    libts_results_cmp   cmp;
+
+    LIBTS_UNIT_CHECK(libts_results_compare(base, TE_ARRAY_LEN(base),
+                                           cur, TE_ARRAY_LEN(cur),
+                                           FALSE, 0.05, &cmp) == 0);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.median_baseline, 11.5, P_EPS);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.median_current, 102, P_EPS);
+    LIBTS_UNIT_CHECK_DOUBLE(cmp.p_value, 1, P_EPS);
+    LIBTS_UNIT_CHECK(!cmp.regressed);
+
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(libts_results_compare(base, 0, cur,
+                                         TE_ARRAY_LEN(cur), FALSE, 0.05,
+                                         &cmp)) == TE_EINVAL);
+}
+
+/**
+ * Check storing and loading samples and regression check against
+ * a stored baseline.
+ */
+static void
+test_store(void)
+{
+    static const double old_build[] = { 10, 11, 12, 13, 14 };
+    static const double new_build[] = { 20, 21, 22, 23, 24 };
+    static const double other[] = { 1, 2, 3, 4, 5 };
+    char                path[] = "/tmp/libts_results_test_XXXXXX";
+    libts_results_key   key;
+    libts_results_cmp   cmp;
+    double             *values = NULL;
+    unsigned int        n_values = 0;
+    int                 fd = mkstemp(path);
+
+    LIBTS_UNIT_CHECK(fd >= 0);
+    close(fd);
+    setenv("SFC_ONLOAD_RESULTS", path, 1);
+    setenv("SFC_ONLOAD_BUILD", "onload-1", 1);
+    setenv("TE_IUT", "host\t1", 1);
+    unsetenv("SFC_ONLOAD_BASELINE_BUILD");
+    unsetenv("SFC_ONLOAD_RESULTS_ALPHA");
+
+    libts_results_key_init(&key, "perf/latency", "size=64");
+    LIBTS_UNIT_CHECK(libts_results_add(&key, "latency_ns", old_build,
+                                       TE_ARRAY_LEN(old_build)) == 0);
+    LIBTS_UNIT_CHECK(libts_results_add(&key, "cpu", other,
+                                       TE_ARRAY_LEN(other)) == 0);
+    key.params = "size=1400";
+    LIBTS_UNIT_CHECK(libts_results_add(&key, "latency_ns", other,
+                                       TE_ARRAY_LEN(other)) == 0);
+
+    key.params = "size=64";
+    LIBTS_UNIT_CHECK(libts_results_load(&key, "latency_ns", &values,
+                                        &n_values) == 0);
+    LIBTS_UNIT_CHECK(n_values == TE_ARRAY_LEN(old_build));
+    LIBTS_UNIT_CHECK(n_values == TE_ARRAY_LEN(old_build) &&
+                     memcmp(values, old_build, sizeof(old_build)) == 0);
+    free(values);
+
+    key.build = "onload-2";
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(libts_results_check_regression(&key,
+                                         NULL, "latency_ns", new_build,
+                                         TE_ARRAY_LEN(new_build), FALSE,
+                                         &cmp)) == TE_ENOENT);
+
+    setenv("SFC_ONLOAD_BASELINE_BUILD", "onload-1", 1);
+    LIBTS_UNIT_CHECK(libts_results_check_regression(&key, NULL,
+                                                    "latency_ns",
+                                                    new_build,
+                                                    TE_ARRAY_LEN(new_build),
+                                                    FALSE, &cmp) == 0);
+    LIBTS_UNIT_CHECK(cmp.regressed);
+    LIBTS_UNIT_CHECK(cmp.n_baseline == TE_ARRAY_LEN(old_build));
+
+    LIBTS_UNIT_CHECK(libts_results_check_regression(&key, "onload-1",
+                                                    "latency_ns",
+                                                    new_build,
+                                                    TE_ARRAY_LEN(new_build),
+                                                    TRUE, &cmp) == 0);
+    LIBTS_UNIT_CHECK(!cmp.regressed);
+
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(libts_results_check_regression(&key,
+                                         "onload-0", "latency_ns",
+                                         new_build, TE_ARRAY_LEN(new_build),
+                                         FALSE, &cmp)) == TE_ENOENT);
+
+    unlink(path);
+}
+
+int
+main(void)
+{
+    test_compare_separated();
+    test_compare_ties();
+    test_compare_few();
+    test_store();
+
+    return libts_unit_result();
+}
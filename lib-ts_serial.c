@@ -0,0 +1,526 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Serial console session API
+ *
+ * Implementation of serial console sessions.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Serial"
+
+#include <pthread.h>
+#include <sys/queue.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "lib-ts.h"
+#include "lib-ts_serial.h"
+#include "tapi_jmp.h"
+#include "tapi_rpc_unistd.h"
+
+/** Default maximum number of lines in a console log */
+#define SERIAL_LOG_LINES_DEF    1024
+
+/** Default console polling interval, ms */
+#define SERIAL_POLL_MS_DEF      100
+
+/** Size of the buffer of a console read */
+#define SERIAL_READ_BUF_SIZE    4096
+
+/** Line of a console log */
+typedef struct serial_line {
+    struct timeval  ts;     /**< Time the line start is read at */
+    char           *text;   /**< Line without the line feed */
+} serial_line;
+
+/** Serial console session */
+struct libts_serial_session {
+    SLIST_ENTRY(libts_serial_session) links;    /**< List links */
+
+    char               *ta;         /**< Test Agent name */
+    char               *console;    /**< Console name */
+    rcf_rpc_server     *rpcs;       /**< RPC server */
+    tapi_serial_handle  handle;     /**< Console handle */
+    pthread_mutex_t     rpc_lock;   /**< Lock serializing RPC calls */
+
+    pthread_t           reader;     /**< Console reading thread */
+    te_bool             reading;    /**< Whether the thread is started */
+    volatile te_bool    stop;       /**< Whether the thread should stop */
+    unsigned int        poll_ms;    /**< Polling interval, ms */
+
+    pthread_mutex_t     log_lock;   /**< Lock protecting the log */
+    serial_line        *lines;      /**< Ring of lines */
+    unsigned int        max_lines;  /**< Size of the ring */
+    unsigned int        first;      /**< Index of the oldest line */
+    unsigned int        n_lines;    /**< Number of lines in the ring */
+    unsigned int        dropped;    /**< Number of lines dropped from
+                                         the ring since the log was
+                                         cleared */
+    te_string           partial;    /**< Read part of the next line */
+    struct timeval      partial_ts; /**< Time the part is read at */
+};
+
+/** Opened sessions */
+static SLIST_HEAD(, libts_serial_session) sessions =
+    SLIST_HEAD_INITIALIZER(sessions);
+
+/** Lock protecting the list of opened sessions */
+static pthread_mutex_t sessions_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Whether the exit handler closing sessions is registered */
+static te_bool sessions_atexit_set = FALSE;
+
+/**
+ * Add a line to the log of a session, dropping the oldest line if the
+ * log is full. Should be called under the log lock.
+ *
+ * @param session   Session.
+ * @param ts        Time the line is read at.
+ * @param text      Line (owned by the log on success).
+ */
+static void
+serial_log_add(libts_serial_session *session, const struct timeval *ts,
+               char *text)
+{
+    serial_line *line;
+
+    if (session->n_lines == session->max_lines)
+    {
+        line = &session->lines[session->first];
+        free(line->text);
+        session->first = (session->first + 1) % session->max_lines;
+        session->n_lines--;
+        session->dropped++;
+    }
+
+    line = &session->lines[(session->first + session->n_lines) %
+                           session->max_lines];
+    line->ts = *ts;
+    line->text = text;
+    session->n_lines++;
+}
+
+/**
+ * Split data read from a console into lines and add them to the log.
+ *
+ * @param session   Session.
+ * @param buf       Read data.
+ * @param len       Length of the data.
+ */
+static void
+serial_log_feed(libts_serial_session *session, const char *buf, size_t len)
+{
+    struct timeval  now;
+    const char     *end;
+    char           *text;
+    size_t          n;
+
+    gettimeofday(&now, NULL);
+
+    pthread_mutex_lock(&session->log_lock);
+    while (len > 0)
+    {
+        end = memchr(buf, '\n', len);
+        n = end == NULL ? len : (size_t)(end - buf);
+
+        if (session->partial.len == 0)
+            session->partial_ts = now;
+        if (n > 0 &&
+            te_string_append(&session->partial, "%.*s", (int)n, buf) != 0)
+        {
+            ERROR("Failed to keep console output of %s", session->ta);
+            break;
+        }
+
+        if (end == NULL)
+            break;
+
+        text = strdup(session->partial.len == 0 ? "" :
+                      session->partial.ptr);
+        if (text != NULL)
+            serial_log_add(session, &session->partial_ts, text);
+        te_string_reset(&session->partial);
+
+        buf += n + 1;
+        len -= n + 1;
+    }
+    pthread_mutex_unlock(&session->log_lock);
+}
+
+/**
+ * Read available console output once catching test failures.
+ *
+ * The console socket is polled and read with separate RPC calls instead
+ * of tapi_serial_read(), so that an error of every call is returned
+ * instead of failing the test from the reading thread. Failures which
+ * still jump (e.g. RPC server death) are caught. The calls are made
+ * several times a second for the whole session, so only failed ones
+ * are logged.
+ *
+ * @param session   Session.
+ * @param buf       Buffer of @c SERIAL_READ_BUF_SIZE bytes.
+ * @param len       Where to put length of the read data.
+ *
+ * @return Status code.
+ */
+static te_errno
+serial_read(libts_serial_session *session, char *buf, size_t *len)
+{
+    rcf_rpc_server     *rpcs = session->rpcs;
+    struct rpc_pollfd   pfd = { .fd = session->handle->sock,
+                                .events = RPC_POLLIN, .revents = 0 };
+    volatile te_bool    jumped = FALSE;
+    int                 rc;
+
+    *len = 0;
+
+    TAPI_ON_JMP(jumped = TRUE);
+    if (jumped)
+        return TE_RC(TE_TAPI, TE_EFAIL);
+
+    RPC_AWAIT_IUT_ERROR(rpcs);
+    rpcs->silent_pass = TRUE;
+    rc = rpc_poll(rpcs, &pfd, 1, 0);
+    if (rc > 0)
+    {
+        RPC_AWAIT_IUT_ERROR(rpcs);
+        rpcs->silent_pass = TRUE;
+        rc = rpc_read(rpcs, pfd.fd, buf, SERIAL_READ_BUF_SIZE);
+        /* End of file is not expected from a console */
+        if (rc == 0)
+        {
+            TAPI_JMP_POP;
+            return TE_RC(TE_TAPI, TE_ECONNRESET);
+        }
+    }
+    TAPI_JMP_POP;
+
+    if (rc < 0)
+        return RPC_ERRNO(rpcs);
+
+    *len = rc;
+    return 0;
+}
+
+/**
+ * Thread reading a console. The RPC server is locked only for the time
+ * of a non-blocking read, so that the console can be written meanwhile.
+ *
+ * @param arg       Session.
+ *
+ * @return @c NULL.
+ */
+static void *
+serial_reader(void *arg)
+{
+    libts_serial_session   *session = arg;
+    char                    buf[SERIAL_READ_BUF_SIZE];
+    size_t                  len;
+    te_errno                rc;
+
+    while (!session->stop)
+    {
+        pthread_mutex_lock(&session->rpc_lock);
+        rc = serial_read(session, buf, &len);
+        pthread_mutex_unlock(&session->rpc_lock);
+
+        if (rc != 0)
+        {
+            WARN("Failed to read console %s of %s, stop capturing: %r",
+                 session->console, session->ta, rc);
+            break;
+        }
+
+        if (len > 0)
+            serial_log_feed(session, buf, len);
+        else
+            usleep(session->poll_ms * 1000);
+    }
+
+    return NULL;
+}
+
+/**
+ * Release a session.
+ *
+ * @param session   Session.
+ */
+static void
+serial_session_free(libts_serial_session *session)
+{
+    unsigned int i;
+
+    for (i = 0; i < session->n_lines; i++)
+        free(session->lines[(session->first + i) % session->max_lines].text);
+    free(session->lines);
+    te_string_free(&session->partial);
+    pthread_mutex_destroy(&session->log_lock);
+    pthread_mutex_destroy(&session->rpc_lock);
+    free(session->console);
+    free(session->ta);
+    free(session);
+}
+
+/**
+ * Open a session.
+ *
+ * @param ta            Test Agent name.
+ * @param rpcs_name     Name of RPC server to create.
+ * @param console       Console name.
+ * @param session       Where to put the session.
+ *
+ * @return Status code.
+ */
+static te_errno
+serial_session_open(const char *ta, const char *rpcs_name,
+                    const char *console, libts_serial_session **session)
+{
+    libts_serial_session   *s;
+    te_errno                rc;
+
+    s = calloc(1, sizeof(*s));
+    if (s == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+
+    s->ta = strdup(ta);
+    s->console = strdup(console);
+    s->max_lines = libts_getenv_uint("SFC_ONLOAD_SERIAL_LOG_LINES",
+                                     1, UINT_MAX, SERIAL_LOG_LINES_DEF);
+    s->poll_ms = libts_getenv_uint("SFC_ONLOAD_SERIAL_POLL_MS",
+                                   1, UINT_MAX, SERIAL_POLL_MS_DEF);
+    s->lines = calloc(s->max_lines, sizeof(*s->lines));
+    s->partial = (te_string)TE_STRING_INIT;
+    pthread_mutex_init(&s->rpc_lock, NULL);
+    pthread_mutex_init(&s->log_lock, NULL);
+    if (s->ta == NULL || s->console == NULL || s->lines == NULL)
+    {
+        serial_session_free(s);
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+    }
+
+    /* It fails when the agent doesn't exist. */
+    rc = rcf_rpc_server_create(ta, rpcs_name, &s->rpcs);
+    if (rc != 0)
+    {
+        WARN("Failed to create RPC server on %s: %r", ta, rc);
+        serial_session_free(s);
+        return rc;
+    }
+
+    RPC_AWAIT_IUT_ERROR(s->rpcs);
+    rc = tapi_serial_open_rpcs(s->rpcs, console, &s->handle);
+    if (rc == 0 && (s->handle == NULL || s->handle->sock <= 0))
+        rc = TE_RC(TE_TAPI, TE_EFAIL);
+    if (rc != 0)
+    {
+        WARN("Failed to open console %s of %s: %r", console, ta, rc);
+        rcf_rpc_server_destroy(s->rpcs);
+        serial_session_free(s);
+        return rc;
+    }
+
+    if (pthread_create(&s->reader, NULL, serial_reader, s) == 0)
+        s->reading = TRUE;
+    else
+        WARN("Failed to start capturing console %s of %s", console, ta);
+
+    *session = s;
+    return 0;
+}
+
+/**
+ * Close sessions left opened at the process exit, e.g. if a test failed
+ * before its cleanup closed them. It is done before RCF connection of
+ * the process is closed, since the handler is registered after it is
+ * opened.
+ */
+static void
+serial_atexit(void)
+{
+    libts_serial_sessions_close_all();
+}
+
+/* See description in lib-ts_serial.h */
+te_errno
+libts_serial_session_get(const char *ta, const char *rpcs_name,
+                         const char *console,
+                         libts_serial_session **session)
+{
+    libts_serial_session   *s;
+    te_errno                rc = 0;
+
+    pthread_mutex_lock(&sessions_lock);
+    SLIST_FOREACH(s, &sessions, links)
+    {
+        if (strcmp(s->ta, ta) == 0 && strcmp(s->console, console) == 0)
+            break;
+    }
+
+    if (s == NULL)
+    {
+        rc = serial_session_open(ta, rpcs_name, console, &s);
+        if (rc == 0)
+            SLIST_INSERT_HEAD(&sessions, s, links);
+    }
+    if (rc == 0 && !sessions_atexit_set)
+    {
+        atexit(serial_atexit);
+        sessions_atexit_set = TRUE;
+    }
+    pthread_mutex_unlock(&sessions_lock);
+
+    if (rc == 0)
+        *session = s;
+
+    return rc;
+}
+
+/* See description in lib-ts_serial.h */
+te_errno
+libts_serial_send_enter(libts_serial_session *session)
+{
+    te_errno rc;
+
+    pthread_mutex_lock(&session->rpc_lock);
+    rc = tapi_serial_force_rw(session->handle);
+    if (rc == 0)
+        rc = tapi_serial_send_enter(session->handle);
+    if (rc == 0)
+        rc = tapi_serial_spy(session->handle);
+    pthread_mutex_unlock(&session->rpc_lock);
+
+    if (rc != 0)
+    {
+        ERROR("Failed to send enter to console %s of %s: %r",
+              session->console, session->ta, rc);
+    }
+
+    return rc;
+}
+
+/* See description in lib-ts_serial.h */
+te_errno
+libts_serial_log_get(libts_serial_session *session, te_bool clear,
+                     te_string *str)
+{
+    const serial_line  *line;
+    struct tm           tm;
+    unsigned int        i;
+    te_errno            rc = 0;
+
+    pthread_mutex_lock(&session->log_lock);
+
+    if (session->dropped > 0)
+    {
+        rc = te_string_append(str, "... %u older lines are dropped\n",
+                              session->dropped);
+    }
+
+    for (i = 0; i < session->n_lines && rc == 0; i++)
+    {
+        line = &session->lines[(session->first + i) % session->max_lines];
+        localtime_r(&line->ts.tv_sec, &tm);
+        rc = te_string_append(str, "[%02d:%02d:%02d.%03ld] %s\n",
+                              tm.tm_hour, tm.tm_min, tm.tm_sec,
+                              (long)line->ts.tv_usec / 1000, line->text);
+    }
+
+    if (rc == 0 && clear)
+    {
+        for (i = 0; i < session->n_lines; i++)
+        {
+            free(session->lines[(session->first + i) %
+                                session->max_lines].text);
+        }
+        session->first = 0;
+        session->n_lines = 0;
+        session->dropped = 0;
+    }
+
+    pthread_mutex_unlock(&session->log_lock);
+
+    return rc;
+}
+
+/* See description in lib-ts_serial.h */
+void
+libts_serial_log_dump(libts_serial_session *session)
+{
+    te_string str = TE_STRING_INIT;
+
+    if (libts_serial_log_get(session, TRUE, &str) != 0)
+        ERROR("Failed to get log of console %s", session->console);
+    else if (str.len > 0)
+        RING("Console %s of %s:\n%s", session->console, session->ta,
+             str.ptr);
+
+    te_string_free(&str);
+}
+
+/* See description in lib-ts_serial.h */
+te_errno
+libts_serial_session_close(libts_serial_session *session)
+{
+    te_errno rc;
+    te_errno rc2;
+
+    pthread_mutex_lock(&sessions_lock);
+    SLIST_REMOVE(&sessions, session, libts_serial_session, links);
+    pthread_mutex_unlock(&sessions_lock);
+
+    if (session->reading)
+    {
+        session->stop = TRUE;
+        pthread_join(session->reader, NULL);
+    }
+
+    /* The reader is stopped, so the last line is not completed */
+    if (session->partial.len > 0)
+    {
+        char *text = strdup(session->partial.ptr);
+
+        if (text != NULL)
+            serial_log_add(session, &session->partial_ts, text);
+    }
+    libts_serial_log_dump(session);
+
+    rc = tapi_serial_close(session->handle);
+    if (rc != 0)
+    {
+        ERROR("Failed to close console %s of %s: %r", session->console,
+              session->ta, rc);
+    }
+
+    rc2 = rcf_rpc_server_destroy(session->rpcs);
+    if (rc == 0)
+        rc = rc2;
+
+    serial_session_free(session);
+    return rc;
+}
+
+/* See description in lib-ts_serial.h */
+te_errno
+libts_serial_sessions_close_all(void)
+{
+    libts_serial_session   *s;
+    te_errno                rc = 0;
+    te_errno                rc2;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&sessions_lock);
+        s = SLIST_FIRST(&sessions);
+        pthread_mutex_unlock(&sessions_lock);
+        if (s == NULL)
+            break;
+
+        rc2 = libts_serial_session_close(s);
+        if (rc == 0)
+            rc = rc2;
+    }
+
+    return rc;
+}
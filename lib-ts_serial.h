@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Serial console session API
+ *
+ * Long-lived sessions with serial consoles of agents. A session keeps one
+ * RPC server and console handle open, so writing to the console does not
+ * require creating them every time, and a thread of the test reads the
+ * console in background and keeps the last lines with timestamps.
+ *
+ * The RPC server of a session is not destroyed after writing to the
+ * console, it lives until the session is closed, which is done at the
+ * test process exit at the latest.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_SERIAL_H__
+#define __ONLOAD_LIB_TS_SERIAL_H__
+
+#include "te_errno.h"
+#include "te_defs.h"
+#include "te_string.h"
+
+/** Serial console session */
+typedef struct libts_serial_session libts_serial_session;
+
+/**
+ * Get a session with a serial console, opening it if it is not opened
+ * yet. Number of kept lines of the console log is limited by
+ * @c SFC_ONLOAD_SERIAL_LOG_LINES (1024 by default), the console is polled
+ * every @c SFC_ONLOAD_SERIAL_POLL_MS milliseconds (100 by default).
+ *
+ * @param ta            Test Agent name.
+ * @param rpcs_name     Name of RPC server to create.
+ * @param console       Console name.
+ * @param session       Where to put the session.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_serial_session_get(const char *ta,
+                                         const char *rpcs_name,
+                                         const char *console,
+                                         libts_serial_session **session);
+
+/**
+ * Set the console to RW mode, send enter and return it back to RO mode.
+ *
+ * @param session       Session.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_serial_send_enter(libts_serial_session *session);
+
+/**
+ * Append captured console log, a line per console line prefixed with
+ * the time it is read at.
+ *
+ * @param session       Session.
+ * @param clear         Whether to remove the appended lines from the log.
+ * @param str           Where to append the log.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_serial_log_get(libts_serial_session *session,
+                                     te_bool clear, te_string *str);
+
+/**
+ * Log captured console log and clear it.
+ *
+ * @param session       Session.
+ */
+extern void libts_serial_log_dump(libts_serial_session *session);
+
+/**
+ * Stop capturing, log the rest of the captured console log, close the
+ * console and destroy RPC server of a session.
+ *
+ * @param session       Session.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_serial_session_close(libts_serial_session *session);
+
+/**
+ * Close all opened sessions. It is done automatically at the process
+ * exit for sessions which are not closed.
+ *
+ * @return Status code of the first failure.
+ */
+extern te_errno libts_serial_sessions_close_all(void);
+
+#endif /* !__ONLOAD_LIB_TS_SERIAL_H__ */
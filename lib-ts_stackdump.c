@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Onload stack statistics API
+ *
+ * Implementation of Onload stack statistics snapshots.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Stackdump"
+
+#include "lib-ts.h"
+#include "lib-ts_stackdump.h"
+
+/** Default onload_stackdump tool */
+#define STACKDUMP_DEF "onload_stackdump"
+
+/**
+ * Shell script printing statistics of all stacks. It takes the tool
+ * location as the first positional parameter.
+ */
+#define STACKDUMP_SCRIPT \
+    "sd=$1; command -v \"$sd\" >/dev/null || exit 1; "                     \
+    "ids=$(\"$sd\" list | awk '$1 ~ /^[0-9]+$/ { print $1 }'); "           \
+    "for id in $ids; do \"$sd\" $id stats more_stats | "                   \
+    "awk -F: -v id=$id 'NF == 2 { gsub(/[ \\t]/, \"\"); "                  \
+    "print \"stack.\" id \".\" $1, $2 }'; done | "                         \
+    "awk '{ print; n = $1; sub(/^stack\\.[0-9]+\\./, \"\", n); "           \
+    "if ($2 ~ /^-?[0-9]+$/) s[n] += $2 } "                                 \
+    "END { for (n in s) print \"all.\" n, s[n] }'; "                       \
+    "echo onload.stacks $(echo $ids | wc -w)"
+
+/* See description in lib-ts_stackdump.h */
+te_errno
+libts_stackdump_snapshot(const char *ta, libts_stats *stats)
+{
+    const char *tool = getenv("SFC_ONLOAD_STACKDUMP");
+    te_string   tool_q = TE_STRING_INIT;
+    char       *out = NULL;
+    te_errno    rc;
+
+    if (tool == NULL || tool[0] == '\0')
+        tool = STACKDUMP_DEF;
+
+    rc = libts_shell_quote(&tool_q, tool);
+    if (rc == 0)
+    {
+        rc = libts_ta_shell_get(ta, &out, "set -- %s; " STACKDUMP_SCRIPT,
+                                tool_q.ptr);
+    }
+    te_string_free(&tool_q);
+    if (rc == 0)
+        rc = libts_stats_parse(out, NULL, stats);
+    if (rc != 0)
+    {
+        ERROR("Failed to get Onload stacks statistics on %s: %r", ta, rc);
+        libts_stats_free(stats);
+    }
+
+    free(out);
+    return rc;
+}
+
+/* See description in lib-ts_stackdump.h */
+long long
+libts_stackdump_delta(const libts_stats *before, const libts_stats *after,
+                      const char *name)
+{
+    char        full[256];
+
+    snprintf(full, sizeof(full), "all.%s", name);
+    return libts_stats_delta(before, after, full);
+}
+
+/* See description in lib-ts_stackdump.h */
+te_errno
+libts_stackdump_log_diff(const char *ta, const libts_stats *before,
+                         const libts_stats *after)
+{
+    te_string   json = TE_STRING_INIT;
+    te_errno    rc;
+
+    rc = libts_stats_diff_to_json(before, after, &json);
+    if (rc == 0)
+        RING("Onload stacks statistics deltas on %s: %s", ta, json.ptr);
+    else
+        ERROR("Failed to format Onload stacks statistics deltas");
+
+    te_string_free(&json);
+    return rc;
+}
@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Onload stack statistics API
+ *
+ * Snapshots of statistics of Onload stacks taken with onload_stackdump
+ * tool on an agent which uses Onload socket library (see
+ * libts_copy_socklibs()). The tool location may be specified by
+ * SFC_ONLOAD_STACKDUMP environment variable.
+ *
+ * Snapshots are counters snapshots (see lib-ts_stats.h) with counters
+ * of "stats" and "more_stats" commands of every stack named
+ * "stack.<stack id>.<name>", their sums over all stacks named
+ * "all.<name>" and number of stacks named "onload.stacks".
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_STACKDUMP_H__
+#define __ONLOAD_LIB_TS_STACKDUMP_H__
+
+#include "te_errno.h"
+#include "lib-ts_stats.h"
+
+/**
+ * Take a snapshot of statistics of Onload stacks.
+ *
+ * @param ta        Test Agent name.
+ * @param stats     Where to put the snapshot (should be released with
+ *                  libts_stats_free()).
+ *
+ * @return Status code.
+ */
+extern te_errno libts_stackdump_snapshot(const char *ta,
+                                         libts_stats *stats);
+
+/**
+ * Get delta of a counter summed over all stacks between two snapshots,
+ * e.g. to check that some event did not happen in a measured loop.
+ *
+ * @param before    The earlier snapshot.
+ * @param after     The later snapshot.
+ * @param name      Counter name without "all." prefix.
+ *
+ * @return Delta or @c 0 if there is no such counter.
+ */
+extern long long libts_stackdump_delta(const libts_stats *before,
+                                       const libts_stats *after,
+                                       const char *name);
+
+/**
+ * Log non-zero deltas of statistics of Onload stacks between two
+ * snapshots as a JSON object.
+ *
+ * @param ta        Test Agent name the snapshots are taken on.
+ * @param before    The earlier snapshot.
+ * @param after     The later snapshot.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_stackdump_log_diff(const char *ta,
+                                         const libts_stats *before,
+                                         const libts_stats *after);
+
+#endif /* !__ONLOAD_LIB_TS_STACKDUMP_H__ */
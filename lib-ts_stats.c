@@ -0,0 +1,539 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Counters snapshots API
+ *
+ * Implementation of counters snapshots.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Stats"
+
+#include <ctype.h>
+
+#include "te_mi_log.h"
+#include "lib-ts.h"
+#include "lib-ts_netns.h"
+#include "lib-ts_stats.h"
+
+/**
+ * Shell script printing NIC and kernel counters. It takes the list of
+ * interfaces as positional parameters.
+ */
+#define STATS_NIC_SCRIPT \
+    "for i in \"$@\"; do ethtool -S $i 2>/dev/null | "                    \
+    "awk -F: -v i=$i 'NF == 2 { gsub(/[ \\t]/, \"\"); "                   \
+    "print \"ethtool.\" i \".\" $1, $2 }'; done; "                          \
+    "awk -v ifs=\"$*\" 'BEGIN { n = split(ifs, a, \" \") } "               \
+    "NR == 1 { ncpu = NF; next } "                                         \
+    "{ for (k = 1; k <= n; k++) "                                          \
+    "if ($NF == a[k] || index($NF, a[k] \"-\") == 1) { s = 0; "            \
+    "for (c = 2; c <= ncpu + 1; c++) s += $c; sub(\":\", \"\", $1); "     \
+    "print \"irq.\" $1 \".\" $NF, s; break } }' /proc/interrupts; "        \
+    "awk '$1 == \"NET_RX:\" || $1 == \"NET_TX:\" { s = 0; "                \
+    "for (c = 2; c <= NF; c++) s += $c; sub(\":\", \"\", $1); "            \
+    "print \"softirq.\" $1, s }' /proc/softirqs; "                         \
+    "awk '$1 == p { sub(\":\", \"\", p); "                                 \
+    "for (c = 2; c <= NF; c++) print \"snmp.\" p \".\" h[c], $c; "        \
+    "p = \"\"; next } { p = $1; for (c = 2; c <= NF; c++) h[c] = $c }' "   \
+    "/proc/net/snmp; "                                                     \
+    "tp=0; td=0; ts=0; while read p d s rest; do "                         \
+    "tp=$((tp + 0x$p)); td=$((td + 0x$d)); ts=$((ts + 0x$s)); "            \
+    "done </proc/net/softnet_stat; "                                       \
+    "echo softnet.processed $tp; echo softnet.dropped $td; "               \
+    "echo softnet.time_squeeze $ts"
+
+/** Snapshot taken by libts_stats_nic_begin() */
+static struct {
+    te_bool     taken;      /**< Whether the snapshot is taken */
+    te_bool     atexit_set; /**< Whether the exit handler is registered */
+    libts_stats stats;      /**< Snapshot */
+} nic_begin;
+
+/**
+ * Find position of a counter in a snapshot.
+ *
+ * @param stats     Snapshot.
+ * @param name      Counter name.
+ * @param found     Where to put whether the counter is found.
+ *
+ * @return Index of the counter or where it should be inserted.
+ */
+static unsigned int
+stats_find(const libts_stats *stats, const char *name, te_bool *found)
+{
+    unsigned int    lo = 0;
+    unsigned int    hi = stats->n_stats;
+    unsigned int    mid;
+    int             cmp;
+
+    *found = FALSE;
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        cmp = strcmp(stats->stats[mid].name, name);
+        if (cmp == 0)
+        {
+            *found = TRUE;
+            return mid;
+        }
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/**
+ * Set value of a counter in a snapshot.
+ *
+ * @param stats     Snapshot.
+ * @param name      Counter name (owned by the snapshot on success).
+ * @param value     Counter value.
+ * @param max       Number of allocated counters.
+ *
+ * @return Status code.
+ */
+static te_errno
+stats_set(libts_stats *stats, char *name, long long value,
+          unsigned int *max)
+{
+    libts_stat     *p;
+    unsigned int    i;
+    te_bool         found;
+
+    i = stats_find(stats, name, &found);
+    if (found)
+    {
+        free(name);
+        stats->stats[i].value = value;
+        return 0;
+    }
+
+    if (stats->n_stats == *max)
+    {
+        *max = *max == 0 ? 64 : *max * 2;
+        p = realloc(stats->stats, *max * sizeof(*p));
+        if (p == NULL)
+            return TE_RC(TE_TAPI, TE_ENOMEM);
+        stats->stats = p;
+    }
+
+    memmove(&stats->stats[i + 1], &stats->stats[i],
+            (stats->n_stats - i) * sizeof(*stats->stats));
+    stats->stats[i].name = name;
+    stats->stats[i].value = value;
+    stats->n_stats++;
+
+    return 0;
+}
+
+/**
+ * Parse a line with a counter name and a decimal value.
+ *
+ * @param line      Line (terminated by a line feed or end of string).
+ * @param name_len  Where to put length of the name at the line start.
+ * @param value     Where to put the value.
+ *
+ * @return @c TRUE if the line has the expected format.
+ */
+static te_bool
+stats_parse_line(const char *line, size_t *name_len, long long *value)
+{
+    const char *p = line;
+    char       *end;
+
+    while (*p != '\0' && !isspace((unsigned char)*p))
+        p++;
+    *name_len = p - line;
+    while (*p == ' ' || *p == '\t')
+        p++;
+
+    /* strtoll() skips line feeds, so empty values are checked first */
+    if (*name_len == 0 || *p == '\n' || *p == '\0')
+        return FALSE;
+
+    *value = strtoll(p, &end, 10);
+    if (end == p)
+        return FALSE;
+    while (*end == ' ' || *end == '\t')
+        end++;
+
+    return *end == '\n' || *end == '\0';
+}
+
+/* See description in lib-ts_stats.h */
+te_errno
+libts_stats_parse(const char *text, const char *prefix, libts_stats *stats)
+{
+    unsigned int    max = stats->n_stats;
+    const char     *p = text;
+    size_t          name_len;
+    char           *name;
+    long long       value;
+    te_errno        rc;
+
+    while (p != NULL && *p != '\0')
+    {
+        while (*p == ' ' || *p == '\t')
+            p++;
+
+        if (stats_parse_line(p, &name_len, &value))
+        {
+            if (asprintf(&name, "%s%.*s", prefix == NULL ? "" : prefix,
+                         (int)name_len, p) < 0)
+                return TE_RC(TE_TAPI, TE_ENOMEM);
+
+            rc = stats_set(stats, name, value, &max);
+            if (rc != 0)
+            {
+                free(name);
+                return rc;
+            }
+        }
+
+        p = strchr(p, '\n');
+        if (p != NULL)
+            p++;
+    }
+
+    return 0;
+}
+
+/* See description in lib-ts_stats.h */
+te_errno
+libts_stats_get(const libts_stats *stats, const char *name,
+                long long *value)
+{
+    unsigned int    i;
+    te_bool         found;
+
+    i = stats_find(stats, name, &found);
+    if (!found)
+        return TE_RC(TE_TAPI, TE_ENOENT);
+
+    *value = stats->stats[i].value;
+    return 0;
+}
+
+/* See description in lib-ts_stats.h */
+long long
+libts_stats_delta(const libts_stats *before, const libts_stats *after,
+                  const char *name)
+{
+    long long   old = 0;
+    long long   new;
+
+    if (libts_stats_get(after, name, &new) != 0)
+        return 0;
+    libts_stats_get(before, name, &old);
+
+    return new - old;
+}
+
+/**
+ * Append a string as a JSON string.
+ *
+ * @param str       Where to append.
+ * @param s         String.
+ *
+ * @return Status code.
+ */
+static te_errno
+stats_json_string(te_string *str, const char *s)
+{
+    te_errno rc;
+
+    rc = te_string_append(str, "\"");
+    for (; *s != '\0' && rc == 0; s++)
+    {
+        if (*s == '"' || *s == '\\')
+            rc = te_string_append(str, "\\%c", *s);
+        else if ((unsigned char)*s < 0x20)
+            rc = te_string_append(str, "\\u%04x", (unsigned char)*s);
+        else
+            rc = te_string_append(str, "%c", *s);
+    }
+    if (rc == 0)
+        rc = te_string_append(str, "\"");
+
+    return rc;
+}
+
+/**
+ * Callback for a counter changed between two snapshots.
+ *
+ * @param name      Counter name.
+ * @param delta     Non-zero delta.
+ * @param opaque    Callback data.
+ *
+ * @return Status code.
+ */
+typedef te_errno (stats_diff_cb)(const char *name, long long delta,
+                                 void *opaque);
+
+/**
+ * Call a callback for each non-zero delta of counters between two
+ * snapshots in the order of counter names. Counters missing in
+ * @p after are ignored, counters missing in @p before are considered
+ * to be zero there.
+ *
+ * @param before    The earlier snapshot.
+ * @param after     The later snapshot.
+ * @param cb        Callback.
+ * @param opaque    Callback data.
+ *
+ * @return Status code (the first non-zero code returned by @p cb).
+ */
+static te_errno
+stats_diff_foreach(const libts_stats *before, const libts_stats *after,
+                   stats_diff_cb *cb, void *opaque)
+{
+    unsigned int    i;
+    unsigned int    j = 0;
+    long long       old;
+    int             cmp;
+    te_errno        rc = 0;
+
+    /* Both snapshots are sorted by name, so they are merged */
+    for (i = 0; i < after->n_stats && rc == 0; i++)
+    {
+        old = 0;
+        for (; j < before->n_stats; j++)
+        {
+            cmp = strcmp(before->stats[j].name, after->stats[i].name);
+            if (cmp == 0)
+                old = before->stats[j].value;
+            if (cmp >= 0)
+                break;
+        }
+
+        if (after->stats[i].value != old)
+            rc = cb(after->stats[i].name, after->stats[i].value - old, opaque);
+    }
+
+    return rc;
+}
+
+/**
+ * Append a JSON object member for a counter delta, see stats_diff_cb.
+ *
+ * @param name      Counter name.
+ * @param delta     Delta.
+ * @param opaque    JSON string with the opening brace.
+ *
+ * @return Status code.
+ */
+static te_errno
+stats_diff_json_member(const char *name, long long delta, void *opaque)
+{
+    te_string  *str = opaque;
+    te_errno    rc = 0;
+
+    if (str->ptr[str->len - 1] != '{')
+        rc = te_string_append(str, ",");
+    if (rc == 0)
+        rc = stats_json_string(str, name);
+    if (rc == 0)
+        rc = te_string_append(str, ":%lld", delta);
+
+    return rc;
+}
+
+/* See description in lib-ts_stats.h */
+te_errno
+libts_stats_diff_to_json(const libts_stats *before,
+                         const libts_stats *after, te_string *str)
+{
+    te_errno rc;
+
+    rc = te_string_append(str, "{");
+    if (rc == 0)
+        rc = stats_diff_foreach(before, after, stats_diff_json_member, str);
+    if (rc == 0)
+        rc = te_string_append(str, "}");
+
+    return rc;
+}
+
+/**
+ * Add a counter delta to an MI artifact, see stats_diff_cb.
+ *
+ * @param name      Counter name.
+ * @param delta     Delta.
+ * @param opaque    MI logger.
+ *
+ * @return Status code.
+ */
+static te_errno
+stats_diff_mi_comment(const char *name, long long delta, void *opaque)
+{
+    te_errno rc = 0;
+
+    te_mi_logger_add_comment(opaque, &rc, name, "%lld", delta);
+    return rc;
+}
+
+/* See description in lib-ts_stats.h */
+void
+libts_stats_free(libts_stats *stats)
+{
+    unsigned int i;
+
+    for (i = 0; i < stats->n_stats; i++)
+        free(stats->stats[i].name);
+    free(stats->stats);
+    stats->stats = NULL;
+    stats->n_stats = 0;
+}
+
+/* See description in lib-ts_stats.h */
+te_errno
+libts_stats_nic_snapshot(libts_stats *stats)
+{
+    static const char *iut_ifs[] = { "TE_ORIG_IUT_TST1",
+                                     "TE_ORIG_IUT_TST1_IUT",
+                                     "TE_ORIG_IUT_TST1_IUT2",
+                                     "TE_ORIG_IUT_TST1_IUT3"
+                                   };
+    te_string       ifs = TE_STRING_INIT;
+    const char     *ifname;
+    char           *ta = NULL;
+    char           *out = NULL;
+    unsigned int    i;
+    te_errno        rc;
+
+    rc = libts_netns_get_sfc_ta(&ta);
+    if (rc != 0)
+        return rc;
+
+    for (i = 0; rc == 0 && i < TE_ARRAY_LEN(iut_ifs); i++)
+    {
+        ifname = libts_netns_slot_getenv(iut_ifs[i]);
+        if (ifname != NULL && ifname[0] != '\0')
+        {
+            rc = te_string_append(&ifs, " ");
+            if (rc == 0)
+                rc = libts_shell_quote(&ifs, ifname);
+        }
+    }
+
+    if (rc == 0)
+    {
+        rc = libts_ta_shell_get(ta, &out, "set --%s; " STATS_NIC_SCRIPT,
+                                ifs.len == 0 ? "" : ifs.ptr);
+    }
+    if (rc == 0)
+        rc = libts_stats_parse(out, NULL, stats);
+    if (rc != 0)
+    {
+        ERROR("Failed to get NIC and kernel counters on %s: %r", ta, rc);
+        libts_stats_free(stats);
+    }
+
+    free(out);
+    free(ta);
+    te_string_free(&ifs);
+    return rc;
+}
+
+/**
+ * Log counters deltas at the process exit if libts_stats_nic_end()
+ * is not called, e.g. if a test failed.
+ */
+static void
+stats_nic_atexit(void)
+{
+    if (nic_begin.taken)
+        libts_stats_nic_end();
+}
+
+/* See description in lib-ts_stats.h */
+te_errno
+libts_stats_nic_begin(void)
+{
+    te_errno rc;
+
+    libts_stats_free(&nic_begin.stats);
+    nic_begin.taken = FALSE;
+
+    rc = libts_stats_nic_snapshot(&nic_begin.stats);
+    if (rc != 0)
+        return rc;
+
+    nic_begin.taken = TRUE;
+    if (!nic_begin.atexit_set)
+    {
+        atexit(stats_nic_atexit);
+        nic_begin.atexit_set = TRUE;
+    }
+
+    return 0;
+}
+
+/* See description in lib-ts_stats.h */
+te_errno
+libts_stats_nic_end(void)
+{
+    libts_stats     after = LIBTS_STATS_INIT;
+    te_mi_logger   *logger = NULL;
+    char           *ta = NULL;
+    te_errno        rc;
+
+    if (!nic_begin.taken)
+    {
+        ERROR("NIC and kernel counters are not taken at the test start");
+        return TE_RC(TE_TAPI, TE_ENOENT);
+    }
+    nic_begin.taken = FALSE;
+
+    rc = libts_netns_get_sfc_ta(&ta);
+    if (rc == 0)
+        rc = libts_stats_nic_snapshot(&after);
+    if (rc == 0)
+        rc = te_mi_logger_meas_create("libts_stats", &logger);
+    if (rc == 0)
+        te_mi_logger_add_meas_key(logger, &rc, "ta", "%s", ta);
+    if (rc == 0)
+    {
+        rc = stats_diff_foreach(&nic_begin.stats, &after,
+                                stats_diff_mi_comment, logger);
+    }
+    if (rc != 0)
+        ERROR("Failed to log NIC and kernel counters deltas: %r", rc);
+
+    /* The artifact is logged when the logger is destroyed */
+    if (logger != NULL)
+        te_mi_logger_destroy(logger);
+    libts_stats_free(&after);
+    libts_stats_free(&nic_begin.stats);
+    free(ta);
+    return rc;
+}
+
+/* See description in lib-ts_stats.h */
+te_errno
+libts_stats_nic_test_start(void)
+{
+    te_errno rc;
+
+    if (!tapi_getenv_bool("SF_TS_NIC_STATS"))
+        return 0;
+
+    rc = libts_stats_nic_begin();
+    if (rc != 0)
+        WARN("NIC and kernel counters deltas will not be logged: %r", rc);
+
+    return rc;
+}
+
+/* See description in lib-ts_stats.h */
+void
+libts_stats_nic_test_end(void)
+{
+    if (nic_begin.taken)
+        libts_stats_nic_end();
+}
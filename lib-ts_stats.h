@@ -0,0 +1,155 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Counters snapshots API
+ *
+ * Snapshots of named counters and their deltas in JSON form. Snapshots
+ * of NIC and kernel counters of the SFC interfaces are taken on the agent
+ * returned by libts_netns_get_sfc_ta():
+ * - ethtool statistics of TE_ORIG_IUT_TST1* interfaces
+ *   ("ethtool.<interface>.<name>");
+ * - interrupts of the interfaces from /proc/interrupts
+ *   ("irq.<number>.<name>", sum over CPUs);
+ * - NET_RX and NET_TX softirqs ("softirq.<name>", sum over CPUs);
+ * - /proc/net/snmp ("snmp.<protocol>.<name>");
+ * - /proc/net/softnet_stat ("softnet.processed", "softnet.dropped",
+ *   "softnet.time_squeeze", sum over CPUs).
+ *
+ * Deltas around a test are logged as an MI measurement artifact of
+ * "libts_stats" tool with "ta" key and a comment per changed counter
+ * (counter name and delta). Test suites enable it by calling
+ * libts_stats_nic_test_start() and libts_stats_nic_test_end() from their
+ * TEST_START_SPECIFIC and TEST_END_SPECIFIC.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_STATS_H__
+#define __ONLOAD_LIB_TS_STATS_H__
+
+#include "te_errno.h"
+#include "te_string.h"
+
+/** Counter */
+typedef struct libts_stat {
+    char       *name;       /**< Counter name */
+    long long   value;      /**< Counter value */
+} libts_stat;
+
+/** Snapshot of counters */
+typedef struct libts_stats {
+    libts_stat     *stats;      /**< Counters sorted by name */
+    unsigned int    n_stats;    /**< Number of counters */
+} libts_stats;
+
+/** Initializer of an empty snapshot */
+#define LIBTS_STATS_INIT { NULL, 0 }
+
+/**
+ * Add counters from text with a line per counter: a name and a decimal
+ * value separated by spaces. Lines of other format are ignored.
+ * A counter which is already in the snapshot is replaced.
+ *
+ * @param text      Text to parse.
+ * @param prefix    Prefix to add to names or @c NULL.
+ * @param stats     Snapshot.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_stats_parse(const char *text, const char *prefix,
+                                  libts_stats *stats);
+
+/**
+ * Get value of a counter.
+ *
+ * @param stats     Snapshot.
+ * @param name      Counter name.
+ * @param value     Where to put the value.
+ *
+ * @return Status code (@c TE_ENOENT if there is no such counter).
+ */
+extern te_errno libts_stats_get(const libts_stats *stats, const char *name,
+                                long long *value);
+
+/**
+ * Get delta of a counter between two snapshots. A counter missing in
+ * @p before is considered to be zero there.
+ *
+ * @param before    The earlier snapshot.
+ * @param after     The later snapshot.
+ * @param name      Counter name.
+ *
+ * @return Delta or @c 0 if there is no such counter in @p after.
+ */
+extern long long libts_stats_delta(const libts_stats *before,
+                                   const libts_stats *after,
+                                   const char *name);
+
+/**
+ * Append non-zero deltas of counters between two snapshots as a JSON
+ * object with a member per counter. Counters missing in @p after are
+ * ignored, counters missing in @p before are considered to be zero
+ * there.
+ *
+ * @param before    The earlier snapshot.
+ * @param after     The later snapshot.
+ * @param str       Where to append the object.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_stats_diff_to_json(const libts_stats *before,
+                                         const libts_stats *after,
+                                         te_string *str);
+
+/**
+ * Release a snapshot.
+ *
+ * @param stats     Snapshot.
+ */
+extern void libts_stats_free(libts_stats *stats);
+
+/**
+ * Take a snapshot of NIC and kernel counters of the SFC interfaces.
+ *
+ * @param stats     Where to put the snapshot (should be released with
+ *                  libts_stats_free()).
+ *
+ * @return Status code.
+ */
+extern te_errno libts_stats_nic_snapshot(libts_stats *stats);
+
+/**
+ * Take a snapshot of NIC and kernel counters at the start of a test.
+ * If libts_stats_nic_end() is not called, it is done at the process
+ * exit.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_stats_nic_begin(void);
+
+/**
+ * Take a snapshot of NIC and kernel counters at the end of a test and
+ * log non-zero deltas since libts_stats_nic_begin() as an MI artifact.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_stats_nic_end(void);
+
+/**
+ * Test start hook: call libts_stats_nic_begin() if SF_TS_NIC_STATS
+ * environment variable is @c TRUE. Deltas are logged by
+ * libts_stats_nic_test_end() or at the process exit if a test jumps
+ * over it.
+ *
+ * @return Status code (failures are also logged as warnings, a test
+ *         may go on without counters).
+ */
+extern te_errno libts_stats_nic_test_start(void);
+
+/**
+ * Test end hook: call libts_stats_nic_end() if counters are taken by
+ * libts_stats_nic_test_start().
+ */
+extern void libts_stats_nic_test_end(void);
+
+#endif /* !__ONLOAD_LIB_TS_STATS_H__ */
@@ -0,0 +1,509 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Setup steps executor API
+ *
+ * Implementation of setup steps executor.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Steps"
+
+#include <pthread.h>
+#include <time.h>
+
+#include "lib-ts.h"
+#include "lib-ts_netns.h"
+#include "lib-ts_timestamps.h"
+#include "lib-ts_timing.h"
+#include "lib-ts_steps.h"
+#include "tapi_jmp.h"
+
+/** Default maximum number of concurrently running steps */
+#define STEPS_PARALLEL_DEF  8
+
+/** State of a step */
+typedef enum step_state {
+    STEP_PENDING,   /**< Step is not started */
+    STEP_RUNNING,   /**< Step is running */
+    STEP_DONE,      /**< Step is successfully done */
+    STEP_FAILED,    /**< Step is failed */
+} step_state;
+
+struct steps_run;
+
+/** Run-time data of a step */
+typedef struct step_ctx {
+    const libts_step   *step;       /**< Step declaration */
+    struct steps_run   *run;        /**< Run the step belongs to */
+    step_state          state;      /**< Step state */
+    te_errno            rc;         /**< Status code of the step */
+    int                 deps[LIBTS_STEP_DEPS_MAX]; /**< Indexes of
+                                                        dependencies */
+    unsigned int        n_deps;     /**< Number of dependencies */
+    double              start;      /**< Start time since the run start,
+                                         ms */
+    double              end;        /**< End time since the run start,
+                                         ms */
+    te_bool             threaded;   /**< Whether the step is run in
+                                         a separate thread */
+    pthread_t           thread;     /**< Thread running the step */
+} step_ctx;
+
+/** Run of steps */
+typedef struct steps_run {
+    step_ctx           *ctx;        /**< Steps */
+    unsigned int        n_steps;    /**< Number of steps */
+    unsigned int        running;    /**< Number of running steps */
+    te_bool             failed;     /**< Whether a step is failed */
+    double              base;       /**< Start time of the run, ms */
+    pthread_mutex_t     lock;       /**< Lock protecting the run */
+    pthread_cond_t      cond;       /**< Signalled when a step is
+                                         finished */
+} steps_run;
+
+/**
+ * Get maximum number of concurrently running steps.
+ *
+ * @return Number of steps.
+ */
+static unsigned int
+steps_parallel(void)
+{
+    return libts_getenv_uint("SFC_ONLOAD_STEPS_PARALLEL", 1, UINT_MAX,
+                             STEPS_PARALLEL_DEF);
+}
+
+/**
+ * Resolve dependencies of steps to indexes and check that there are
+ * no unknown names and no cycles.
+ *
+ * @param run       Run of steps.
+ *
+ * @return Status code.
+ */
+static te_errno
+steps_resolve(steps_run *run)
+{
+    unsigned int   *n_left;
+    unsigned int   *order;
+    unsigned int    n_order = 0;
+    unsigned int    i;
+    unsigned int    j;
+    unsigned int    k;
+
+    for (i = 0; i < run->n_steps; i++)
+    {
+        step_ctx   *ctx = &run->ctx[i];
+
+        for (j = 0; j < i; j++)
+        {
+            if (strcmp(run->ctx[j].step->name, ctx->step->name) == 0)
+            {
+                ERROR("Step '%s' is declared twice", ctx->step->name);
+                return TE_RC(TE_TAPI, TE_EINVAL);
+            }
+        }
+
+        for (j = 0; j < LIBTS_STEP_DEPS_MAX &&
+                    ctx->step->deps[j] != NULL; j++)
+        {
+            for (k = 0; k < run->n_steps; k++)
+            {
+                if (strcmp(run->ctx[k].step->name,
+                           ctx->step->deps[j]) == 0)
+                    break;
+            }
+            if (k == run->n_steps || k == i)
+            {
+                ERROR("Step '%s' depends on unknown step '%s'",
+                      ctx->step->name, ctx->step->deps[j]);
+                return TE_RC(TE_TAPI, TE_EINVAL);
+            }
+            ctx->deps[ctx->n_deps++] = k;
+        }
+    }
+
+    /* Check that steps can be ordered, i.e. there are no cycles */
+    n_left = calloc(run->n_steps, sizeof(*n_left));
+    order = calloc(run->n_steps, sizeof(*order));
+    if (n_left == NULL || order == NULL)
+    {
+        free(n_left);
+        free(order);
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+    }
+
+    for (i = 0; i < run->n_steps; i++)
+    {
+        n_left[i] = run->ctx[i].n_deps;
+        if (n_left[i] == 0)
+            order[n_order++] = i;
+    }
+    for (i = 0; i < n_order; i++)
+    {
+        for (j = 0; j < run->n_steps; j++)
+        {
+            for (k = 0; k < run->ctx[j].n_deps; k++)
+            {
+                if (run->ctx[j].deps[k] == (int)order[i] &&
+                    --n_left[j] == 0)
+                    order[n_order++] = j;
+            }
+        }
+    }
+    free(n_left);
+    free(order);
+
+    if (n_order != run->n_steps)
+    {
+        ERROR("Dependencies of steps have a cycle");
+        return TE_RC(TE_TAPI, TE_EINVAL);
+    }
+
+    return 0;
+}
+
+/**
+ * Check whether a step is ready to be started.
+ * Should be called under the lock of the run.
+ *
+ * @param ctx       Step.
+ *
+ * @return @c TRUE if the step is ready.
+ */
+static te_bool
+step_ready(const step_ctx *ctx)
+{
+    unsigned int i;
+
+    if (ctx->state != STEP_PENDING)
+        return FALSE;
+
+    for (i = 0; i < ctx->n_deps; i++)
+    {
+        if (ctx->run->ctx[ctx->deps[i]].state != STEP_DONE)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Call step function catching test failures.
+ *
+ * @param step      Step.
+ *
+ * @return Status code.
+ */
+static te_errno
+step_call(const libts_step *step)
+{
+    volatile te_bool    jumped = FALSE;
+    te_errno            rc;
+
+    TAPI_ON_JMP(jumped = TRUE);
+    if (jumped)
+        return TE_RC(TE_TAPI, TE_EFAIL);
+
+    rc = step->func(step->arg);
+    TAPI_JMP_POP;
+
+    return rc;
+}
+
+/**
+ * Execute a step and update its state.
+ *
+ * @param ctx       Step.
+ */
+static void
+step_exec(step_ctx *ctx)
+{
+    steps_run      *run = ctx->run;
+    unsigned int    depth = libts_timing_depth();
+    te_errno        rc;
+
+    RING("Step '%s' is started", ctx->step->name);
+    libts_timing_start("step:%s", ctx->step->name);
+    rc = step_call(ctx->step);
+    /* Steps of the timeline may be left open if the step jumped out */
+    libts_timing_stop_to(depth);
+    if (rc != 0)
+        ERROR("Step '%s' failed: %r", ctx->step->name, rc);
+    else
+        RING("Step '%s' is done", ctx->step->name);
+
+    pthread_mutex_lock(&run->lock);
+    ctx->end = libts_monotonic_ms() - run->base;
+    ctx->rc = rc;
+    ctx->state = rc == 0 ? STEP_DONE : STEP_FAILED;
+    if (rc != 0)
+        run->failed = TRUE;
+    run->running--;
+    pthread_cond_broadcast(&run->cond);
+    pthread_mutex_unlock(&run->lock);
+}
+
+/**
+ * Thread running a step.
+ *
+ * @param arg       Step.
+ *
+ * @return @c NULL.
+ */
+static void *
+step_thread(void *arg)
+{
+    step_exec(arg);
+    return NULL;
+}
+
+/**
+ * Mark a step as running. Should be called under the lock of the run.
+ *
+ * @param ctx       Step.
+ */
+static void
+step_mark_running(step_ctx *ctx)
+{
+    ctx->state = STEP_RUNNING;
+    ctx->start = libts_monotonic_ms() - ctx->run->base;
+    ctx->run->running++;
+}
+
+/**
+ * Log duration of steps in the order of declaration and the critical
+ * path of the run, i.e. the chain of dependent steps which determined
+ * the run duration.
+ *
+ * @param run       Run of steps.
+ */
+static void
+steps_report(const steps_run *run)
+{
+    te_string       str = TE_STRING_INIT;
+    double          serial = 0;
+    double          total = 0;
+    int            *path;
+    unsigned int    n_path = 0;
+    unsigned int    i;
+    int             cur = -1;
+
+    te_string_append(&str, "Steps:\n");
+    for (i = 0; i < run->n_steps; i++)
+    {
+        const step_ctx *ctx = &run->ctx[i];
+
+        if (ctx->state == STEP_PENDING)
+        {
+            te_string_append(&str, "  %-24s not started\n",
+                             ctx->step->name);
+            continue;
+        }
+
+        te_string_append(&str, "  %-24s start %10.3f ms, "
+                         "duration %10.3f ms%s\n", ctx->step->name,
+                         ctx->start, ctx->end - ctx->start,
+                         ctx->state == STEP_FAILED ? ", FAILED" : "");
+        serial += ctx->end - ctx->start;
+        if (cur < 0 || ctx->end > run->ctx[cur].end)
+            cur = i;
+    }
+
+    path = calloc(run->n_steps, sizeof(*path));
+    while (path != NULL && cur >= 0)
+    {
+        const step_ctx *ctx = &run->ctx[cur];
+
+        path[n_path++] = cur;
+        cur = -1;
+        for (i = 0; i < ctx->n_deps; i++)
+        {
+            if (cur < 0 || run->ctx[ctx->deps[i]].end > run->ctx[cur].end)
+                cur = ctx->deps[i];
+        }
+    }
+
+    if (n_path > 0)
+    {
+        total = run->ctx[path[0]].end;
+        te_string_append(&str, "Critical path:");
+        while (n_path-- > 0)
+        {
+            const step_ctx *ctx = &run->ctx[path[n_path]];
+
+            te_string_append(&str, " %s (%.3f ms)%s", ctx->step->name,
+                             ctx->end - ctx->start,
+                             n_path > 0 ? " ->" : "\n");
+        }
+    }
+    free(path);
+
+    te_string_append(&str, "Total %.3f ms, sum of steps %.3f ms",
+                     total, serial);
+    RING("%s", str.ptr);
+    te_string_free(&str);
+}
+
+/* See description in lib-ts_steps.h */
+te_errno
+libts_steps_run(const libts_step *steps, unsigned int n_steps)
+{
+    steps_run       run;
+    unsigned int    parallel = steps_parallel();
+    unsigned int    i;
+    te_errno        rc;
+
+    memset(&run, 0, sizeof(run));
+    run.n_steps = n_steps;
+    run.ctx = calloc(n_steps, sizeof(*run.ctx));
+    if (run.ctx == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+    for (i = 0; i < n_steps; i++)
+    {
+        run.ctx[i].step = &steps[i];
+        run.ctx[i].run = &run;
+    }
+
+    rc = steps_resolve(&run);
+    if (rc != 0)
+    {
+        free(run.ctx);
+        return rc;
+    }
+
+    pthread_mutex_init(&run.lock, NULL);
+    pthread_cond_init(&run.cond, NULL);
+    run.base = libts_monotonic_ms();
+
+    pthread_mutex_lock(&run.lock);
+    for (;;)
+    {
+        step_ctx   *main_ctx = NULL;
+
+        for (i = 0; i < n_steps && !run.failed; i++)
+        {
+            step_ctx *ctx = &run.ctx[i];
+
+            if (!step_ready(ctx))
+                continue;
+
+            if (ctx->step->main_thread || parallel == 1)
+            {
+                if (main_ctx == NULL)
+                    main_ctx = ctx;
+                continue;
+            }
+
+            if (run.running >= parallel)
+                continue;
+
+            step_mark_running(ctx);
+            if (pthread_create(&ctx->thread, NULL, step_thread, ctx) != 0)
+            {
+                WARN("Failed to create thread for step '%s', run it "
+                     "in the calling thread", ctx->step->name);
+                pthread_mutex_unlock(&run.lock);
+                step_exec(ctx);
+                pthread_mutex_lock(&run.lock);
+                continue;
+            }
+            ctx->threaded = TRUE;
+        }
+
+        /*
+         * The calling thread runs its steps itself, so it does not wait
+         * for threads while there is such a step to do.
+         */
+        if (main_ctx != NULL)
+        {
+            step_mark_running(main_ctx);
+            pthread_mutex_unlock(&run.lock);
+            step_exec(main_ctx);
+            pthread_mutex_lock(&run.lock);
+            continue;
+        }
+
+        if (run.running == 0)
+            break;
+
+        pthread_cond_wait(&run.cond, &run.lock);
+    }
+    pthread_mutex_unlock(&run.lock);
+
+    for (i = 0; i < n_steps; i++)
+    {
+        if (run.ctx[i].threaded)
+            pthread_join(run.ctx[i].thread, NULL);
+    }
+
+    steps_report(&run);
+
+    rc = 0;
+    for (i = 0; i < n_steps && rc == 0; i++)
+        rc = run.ctx[i].rc;
+
+    pthread_cond_destroy(&run.cond);
+    pthread_mutex_destroy(&run.lock);
+    free(run.ctx);
+
+    return rc;
+}
+
+/* See description in lib-ts_steps.h */
+te_errno
+libts_step_fix_tas_path_env(void *arg)
+{
+    UNUSED(arg);
+
+    libts_fix_tas_path_env();
+    return 0;
+}
+
+/* See description in lib-ts_steps.h */
+te_errno
+libts_step_copy_socklibs(void *arg)
+{
+    UNUSED(arg);
+
+    return libts_copy_socklibs();
+}
+
+/* See description in lib-ts_steps.h */
+te_errno
+libts_step_setup_namespace(void *arg)
+{
+    return libts_setup_namespace(*(libts_netns_conn_mode *)arg);
+}
+
+/* See description in lib-ts_steps.h */
+te_errno
+libts_step_set_zf_host_addr(void *arg)
+{
+    UNUSED(arg);
+
+    libts_set_zf_host_addr();
+    return 0;
+}
+
+/* See description in lib-ts_steps.h */
+te_errno
+libts_step_init_console_loglevel(void *arg)
+{
+    UNUSED(arg);
+
+    libts_init_console_loglevel();
+    return 0;
+}
+
+/* See description in lib-ts_steps.h */
+te_errno
+libts_step_configure_sfptpd(void *arg)
+{
+    UNUSED(arg);
+
+    libts_timestamps_configure_sfptpd();
+    return 0;
+}
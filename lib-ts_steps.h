@@ -0,0 +1,139 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Setup steps executor API
+ *
+ * Executor of setup steps (e.g. in prologue) declared together with
+ * their dependencies. Steps which do not depend on each other are run
+ * concurrently, every step is started as soon as all the steps it
+ * depends on are done.
+ *
+ * Example of a prologue:
+ * @code
+ * libts_netns_conn_mode mode = LIBTS_NETNS_CONN_MACVLAN;
+ * libts_step steps[] = {
+ *     { "path", libts_step_fix_tas_path_env, NULL, FALSE, { NULL } },
+ *     { "netns", libts_step_setup_namespace, &mode, FALSE, { "path" } },
+ *     { "socklibs", libts_step_copy_socklibs, NULL, FALSE, { "netns" } },
+ *     { "zf_addr", libts_step_set_zf_host_addr, NULL, FALSE,
+ *       { "netns" } },
+ *     { "loglevel", libts_step_init_console_loglevel, NULL, FALSE,
+ *       { NULL } },
+ * };
+ *
+ * CHECK_RC(libts_steps_run(steps, TE_ARRAY_LEN(steps)));
+ * @endcode
+ *
+ * The number of concurrently running steps is limited by
+ * SFC_ONLOAD_STEPS_PARALLEL environment variable (8 by default). If it
+ * is set to @c 1, steps are run one by one in the order of declaration
+ * as far as dependencies allow.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_STEPS_H__
+#define __ONLOAD_LIB_TS_STEPS_H__
+
+#include "te_errno.h"
+#include "te_defs.h"
+
+/** Maximum number of dependencies of a step */
+#define LIBTS_STEP_DEPS_MAX 8
+
+/**
+ * Step function. Failures reported with TEST_FAIL() or TEST_VERDICT()
+ * are caught by the executor and stop the step with @c TE_EFAIL.
+ *
+ * @param arg       Step argument.
+ *
+ * @return Status code.
+ */
+typedef te_errno (*libts_step_func)(void *arg);
+
+/** Setup step */
+typedef struct libts_step {
+    const char         *name;           /**< Unique step name */
+    libts_step_func     func;           /**< Step function */
+    void               *arg;            /**< Step function argument */
+    te_bool             main_thread;    /**< Whether the step must be
+                                             run in the calling thread,
+                                             e.g. since it uses RPC
+                                             servers of the test */
+    const char         *deps[LIBTS_STEP_DEPS_MAX]; /**< Names of steps
+                                                        which should be
+                                                        done before the
+                                                        step, terminated
+                                                        by @c NULL */
+} libts_step;
+
+/**
+ * Run setup steps respecting their dependencies. If a step fails, no
+ * more steps are started, the steps which are already running are
+ * waited for. Duration of every step and the critical path are logged
+ * when all the steps are finished.
+ *
+ * @param steps     Steps.
+ * @param n_steps   Number of steps.
+ *
+ * @return Status code of the first failed step in the order of
+ *         declaration, @c TE_EINVAL if dependencies are not valid.
+ */
+extern te_errno libts_steps_run(const libts_step *steps,
+                                unsigned int n_steps);
+
+/**
+ * Step wrapper of libts_fix_tas_path_env().
+ *
+ * @param arg       Unused.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_step_fix_tas_path_env(void *arg);
+
+/**
+ * Step wrapper of libts_copy_socklibs().
+ *
+ * @param arg       Unused.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_step_copy_socklibs(void *arg);
+
+/**
+ * Step wrapper of libts_setup_namespace().
+ *
+ * @param arg       Pointer to libts_netns_conn_mode.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_step_setup_namespace(void *arg);
+
+/**
+ * Step wrapper of libts_set_zf_host_addr().
+ *
+ * @param arg       Unused.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_step_set_zf_host_addr(void *arg);
+
+/**
+ * Step wrapper of libts_init_console_loglevel().
+ *
+ * @param arg       Unused.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_step_init_console_loglevel(void *arg);
+
+/**
+ * Step wrapper of libts_timestamps_configure_sfptpd().
+ *
+ * @param arg       Unused.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_step_configure_sfptpd(void *arg);
+
+#endif /* !__ONLOAD_LIB_TS_STEPS_H__ */
@@ -0,0 +1,242 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Setup steps executor API unit test
+ *
+ * Checks of validation of the steps graph, of the order of steps run
+ * one by one and concurrently, and of stopping on failures.
+ *
+ * @author agent <agent@local>
+ */
+
+#include <pthread.h>
+
+#include "lib-ts.h"
+#include "lib-ts_steps.h"
+#include "lib-ts_unit.h"
+
+DEFINE_LGR_ENTITY("libts_steps_test");
+
+/** Maximum number of steps in a test graph */
+#define TEST_STEPS_MAX 16
+
+/** Log of step calls */
+static struct {
+    pthread_mutex_t lock;                   /**< Lock protecting the log */
+    unsigned int    n_started;              /**< Number of started steps */
+    unsigned int    n_done;                 /**< Number of done steps */
+    int             started[TEST_STEPS_MAX]; /**< Step numbers in the
+                                                  order of start */
+    unsigned int    done_at_start[TEST_STEPS_MAX]; /**< Number of done
+                                                        steps when a step
+                                                        is started */
+    unsigned int    done_at_end[TEST_STEPS_MAX];   /**< Number of done
+                                                        steps when a step
+                                                        is done */
+    pthread_t       thread[TEST_STEPS_MAX]; /**< Thread of a step */
+} calls = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+/** Step numbers (arguments of test_step()) */
+static int step_ids[TEST_STEPS_MAX] = { 0, 1, 2, 3, 4, 5, 6, 7,
+                                        8, 9, 10, 11, 12, 13, 14, 15 };
+
+/** Number of the step which fails or @c -1 */
+static int step_fail = -1;
+
+/**
+ * Step function: log the call and fail if requested.
+ *
+ * @param arg       Step number.
+ *
+ * @return Status code.
+ */
+static te_errno
+test_step(void *arg)
+{
+    int id = *(int *)arg;
+
+    pthread_mutex_lock(&calls.lock);
+    calls.started[calls.n_started++] = id;
+    calls.done_at_start[id] = calls.n_done;
+    calls.thread[id] = pthread_self();
+    pthread_mutex_unlock(&calls.lock);
+
+    usleep(1000);
+
+    pthread_mutex_lock(&calls.lock);
+    calls.done_at_end[id] = ++calls.n_done;
+    pthread_mutex_unlock(&calls.lock);
+
+    return id == step_fail ? TE_RC(TE_TAPI, TE_ENODEV) : 0;
+}
+
+/**
+ * Reset the log of step calls.
+ */
+static void
+calls_reset(void)
+{
+    calls.n_started = 0;
+    calls.n_done = 0;
+    memset(calls.done_at_start, 0, sizeof(calls.done_at_start));
+    memset(calls.done_at_end, 0, sizeof(calls.done_at_end));
+}
+
+/**
+ * Check that every step is started after all its dependencies are done.
+ *
+ * @param steps     Steps.
+ * @param n_steps   Number of steps.
+ */
+static void
+check_deps_order(const libts_step *steps, unsigned int n_steps)
+{
+    unsigned int    i;
+    unsigned int    j;
+    unsigned int    k;
+
+    for (i = 0; i < n_steps; i++)
+    {
+        for (j = 0; j < LIBTS_STEP_DEPS_MAX && steps[i].deps[j] != NULL;
+             j++)
+        {
+            for (k = 0; k < n_steps; k++)
+            {
+                if (strcmp(steps[k].name, steps[i].deps[j]) == 0)
+                    break;
+            }
+            LIBTS_UNIT_CHECK(k < n_steps);
+            LIBTS_UNIT_CHECK(calls.done_at_end[k] <=
+                             calls.done_at_start[i]);
+        }
+    }
+}
+
+/**
+ * Check that invalid graphs are rejected before any step is run.
+ */
+static void
+test_invalid(void)
+{
+    libts_step dup[] = {
+        { "a", test_step, &step_ids[0], FALSE, { NULL } },
+        { "a", test_step, &step_ids[1], FALSE, { NULL } },
+    };
+    libts_step unknown[] = {
+        { "a", test_step, &step_ids[0], FALSE, { NULL } },
+        { "b", test_step, &step_ids[1], FALSE, { "c" } },
+    };
+    libts_step self[] = {
+        { "a", test_step, &step_ids[0], FALSE, { "a" } },
+    };
+    libts_step cycle[] = {
+        { "a", test_step, &step_ids[0], FALSE, { NULL } },
+        { "b", test_step, &step_ids[1], FALSE, { "a", "d" } },
+        { "c", test_step, &step_ids[2], FALSE, { "b" } },
+        { "d", test_step, &step_ids[3], FALSE, { "c" } },
+    };
+
+    calls_reset();
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(libts_steps_run(dup,
+                                                     TE_ARRAY_LEN(dup)))
+                     == TE_EINVAL);
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(libts_steps_run(unknown,
+                                         TE_ARRAY_LEN(unknown)))
+                     == TE_EINVAL);
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(libts_steps_run(self,
+                                                     TE_ARRAY_LEN(self)))
+                     == TE_EINVAL);
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(libts_steps_run(cycle,
+                                                     TE_ARRAY_LEN(cycle)))
+                     == TE_EINVAL);
+    LIBTS_UNIT_CHECK(calls.n_started == 0);
+}
+
+/** Graph of steps used for order checks */
+static const libts_step graph[] = {
+    { "path", test_step, &step_ids[0], FALSE, { NULL } },
+    { "netns", test_step, &step_ids[1], FALSE, { "path" } },
+    { "socklibs", test_step, &step_ids[2], FALSE, { "netns" } },
+    { "zf_addr", test_step, &step_ids[3], TRUE, { "netns" } },
+    { "loglevel", test_step, &step_ids[4], FALSE, { NULL } },
+    { "sfptpd", test_step, &step_ids[5], FALSE, { "loglevel", "path" } },
+    { "last", test_step, &step_ids[6], FALSE,
+      { "socklibs", "zf_addr", "sfptpd" } },
+};
+
+/**
+ * Check that steps are run one by one in the order of declaration as
+ * far as dependencies allow if SFC_ONLOAD_STEPS_PARALLEL is @c 1.
+ */
+static void
+test_serial(void)
+{
+    static const int    expected[] = { 0, 1, 2, 3, 4, 5, 6 };
+    unsigned int        i;
+
+    setenv("SFC_ONLOAD_STEPS_PARALLEL", "1", 1);
+    calls_reset();
+    LIBTS_UNIT_CHECK(libts_steps_run(graph, TE_ARRAY_LEN(graph)) == 0);
+
+    LIBTS_UNIT_CHECK(calls.n_started == TE_ARRAY_LEN(graph));
+    for (i = 0; i < calls.n_started && i < TE_ARRAY_LEN(expected); i++)
+    {
+        LIBTS_UNIT_CHECK(calls.started[i] == expected[i]);
+        LIBTS_UNIT_CHECK(calls.done_at_start[calls.started[i]] == i);
+        LIBTS_UNIT_CHECK(pthread_equal(calls.thread[calls.started[i]],
+                                       pthread_self()));
+    }
+    check_deps_order(graph, TE_ARRAY_LEN(graph));
+}
+
+/**
+ * Check that concurrently run steps respect dependencies and that
+ * steps of the calling thread are run in it.
+ */
+static void
+test_parallel(void)
+{
+    setenv("SFC_ONLOAD_STEPS_PARALLEL", "4", 1);
+    calls_reset();
+    LIBTS_UNIT_CHECK(libts_steps_run(graph, TE_ARRAY_LEN(graph)) == 0);
+
+    LIBTS_UNIT_CHECK(calls.n_started == TE_ARRAY_LEN(graph));
+    check_deps_order(graph, TE_ARRAY_LEN(graph));
+    LIBTS_UNIT_CHECK(pthread_equal(calls.thread[3], pthread_self()));
+    /* "path" and "loglevel" do not depend on anything */
+    LIBTS_UNIT_CHECK(calls.done_at_start[0] == 0);
+    LIBTS_UNIT_CHECK(calls.done_at_start[4] == 0);
+}
+
+/**
+ * Check that no steps are started after a failure and the status code
+ * of the failed step is returned.
+ */
+static void
+test_failure(void)
+{
+    unsigned int i;
+
+    setenv("SFC_ONLOAD_STEPS_PARALLEL", "1", 1);
+    calls_reset();
+    step_fail = 1;
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(libts_steps_run(graph,
+                                         TE_ARRAY_LEN(graph)))
+                     == TE_ENODEV);
+    step_fail = -1;
+
+    LIBTS_UNIT_CHECK(calls.n_started == 2);
+    for (i = 0; i < calls.n_started; i++)
+        LIBTS_UNIT_CHECK(calls.started[i] != 2 && calls.started[i] != 6);
+}
+
+int
+main(void)
+{
+    test_invalid();
+    test_serial();
+    test_parallel();
+    test_failure();
+
+    return libts_unit_result();
+}
@@ -0,0 +1,343 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Parameter sweep API
+ *
+ * Implementation of parameter sweep runner.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Sweep"
+
+#include <math.h>
+
+#include "lib-ts.h"
+#include "lib-ts_loglevel.h"
+#include "lib-ts_sweep.h"
+
+/**
+ * Get number of values of a parameter.
+ *
+ * @param param     Parameter.
+ *
+ * @return Number of values.
+ */
+static unsigned int
+sweep_param_n_values(const libts_sweep_param *param)
+{
+    unsigned int n = 0;
+
+    while (param->values[n] != NULL)
+        n++;
+
+    return n;
+}
+
+/**
+ * Append description of parameters values of a point.
+ *
+ * @param sweep     Parameter sweep.
+ * @param values    Indexes of parameters values.
+ * @param sep       Separator of values.
+ * @param named     Whether to add parameters names.
+ * @param str       Where to append the description.
+ *
+ * @return Status code.
+ */
+static te_errno
+sweep_point_to_str(const libts_sweep *sweep, const unsigned int *values,
+                   const char *sep, te_bool named, te_string *str)
+{
+    unsigned int    i;
+    te_errno        rc = 0;
+
+    for (i = 0; i < sweep->n_params && rc == 0; i++)
+    {
+        rc = te_string_append(str, "%s%s%s%s", i == 0 ? "" : sep,
+                              named ? sweep->params[i].name : "",
+                              named ? "=" : "",
+                              sweep->params[i].values[values[i]]);
+    }
+
+    return rc;
+}
+
+/**
+ * Update statistics of a metric with a new value (Welford's method,
+ * @a stddev keeps the sum of squared differences until
+ * sweep_stats_finish() is called).
+ *
+ * @param stats     Statistics.
+ * @param value     New value.
+ */
+static void
+sweep_stats_add(libts_sweep_stats *stats, double value)
+{
+    double delta = value - stats->mean;
+
+    stats->n++;
+    stats->mean += delta / stats->n;
+    stats->stddev += delta * (value - stats->mean);
+    if (stats->n == 1 || value < stats->min)
+        stats->min = value;
+    if (stats->n == 1 || value > stats->max)
+        stats->max = value;
+}
+
+/**
+ * Finish calculation of statistics of a metric.
+ *
+ * @param stats     Statistics.
+ */
+static void
+sweep_stats_finish(libts_sweep_stats *stats)
+{
+    stats->stddev = stats->n > 1 ? sqrt(stats->stddev / (stats->n - 1)) : 0;
+}
+
+/**
+ * Run measurements in a point of the parameters grid.
+ *
+ * @param sweep     Parameter sweep.
+ * @param values    Indexes of parameters values of the point.
+ * @param settings  Buffer for settings (@a n_params elements).
+ * @param results   Buffer for measurement results (@a n_metrics
+ *                  elements).
+ * @param stats     Where to put statistics of metrics.
+ *
+ * @return Status code.
+ */
+static te_errno
+sweep_point_run(const libts_sweep *sweep, const unsigned int *values,
+                libts_tune_setting *settings, double *results,
+                libts_sweep_stats *stats)
+{
+    te_string           name = TE_STRING_INIT;
+    libts_tune_profile  profile;
+    libts_tune_backup   backup = LIBTS_TUNE_BACKUP_INIT;
+    unsigned int        i;
+    unsigned int        j;
+    te_errno            rc;
+    te_errno            rc2;
+    te_errno            measure_rc = 0;
+
+    for (i = 0; i < sweep->n_params; i++)
+    {
+        settings[i].kind = sweep->params[i].kind;
+        settings[i].name = sweep->params[i].name;
+        settings[i].value = sweep->params[i].values[values[i]];
+    }
+
+    rc = sweep_point_to_str(sweep, values, ", ", TRUE, &name);
+    if (rc != 0)
+        return rc;
+
+    profile.name = name.ptr;
+    profile.descr = "sweep point";
+    profile.settings = settings;
+    profile.n_settings = sweep->n_params;
+
+    rc = libts_tune_apply(sweep->ta, &profile, &backup);
+    if (rc != 0)
+    {
+        te_string_free(&name);
+        return rc;
+    }
+
+    /* Kernel console output should not disturb the measurements */
+    rc = libts_loglevel_quiet_begin("sweep point %s", name.ptr);
+    if (rc != 0)
+        WARN("Sweep point %s is measured with verbose console", name.ptr);
+
+    for (i = 0; i < sweep->reruns; i++)
+    {
+        memset(results, 0, sweep->n_metrics * sizeof(*results));
+        rc = sweep->measure(sweep->arg, results);
+        if (rc != 0)
+        {
+            ERROR("Measurement %u of sweep point %s failed: %r", i + 1,
+                  name.ptr, rc);
+            measure_rc = rc;
+            continue;
+        }
+
+        for (j = 0; j < sweep->n_metrics; j++)
+            sweep_stats_add(&stats[j], results[j]);
+    }
+
+    libts_loglevel_quiet_end(measure_rc != 0);
+
+    for (j = 0; j < sweep->n_metrics; j++)
+        sweep_stats_finish(&stats[j]);
+
+    rc2 = libts_tune_revert(&backup);
+    te_string_free(&name);
+
+    return measure_rc != 0 ? measure_rc : rc2;
+}
+
+/* See description in lib-ts_sweep.h */
+te_errno
+libts_sweep_run(const libts_sweep *sweep, libts_sweep_result *result)
+{
+    libts_tune_setting *settings = NULL;
+    double             *results = NULL;
+    unsigned int       *n_values = NULL;
+    unsigned int       *values;
+    unsigned int        n_points = 1;
+    unsigned int        point;
+    unsigned int        i;
+    te_errno            rc = 0;
+    te_errno            first_rc = 0;
+
+    memset(result, 0, sizeof(*result));
+
+    if (sweep->reruns == 0 || sweep->n_metrics == 0)
+    {
+        ERROR("Sweep should have at least one measurement and metric");
+        return TE_RC(TE_TAPI, TE_EINVAL);
+    }
+
+    n_values = calloc(sweep->n_params + 1, sizeof(*n_values));
+    if (n_values == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+
+    for (i = 0; i < sweep->n_params; i++)
+    {
+        n_values[i] = sweep_param_n_values(&sweep->params[i]);
+        if (n_values[i] == 0)
+        {
+            ERROR("Swept parameter %s has no values",
+                  sweep->params[i].name);
+            free(n_values);
+            return TE_RC(TE_TAPI, TE_EINVAL);
+        }
+        n_points *= n_values[i];
+    }
+
+    settings = calloc(sweep->n_params + 1, sizeof(*settings));
+    results = calloc(sweep->n_metrics, sizeof(*results));
+    result->values = calloc(n_points * sweep->n_params + 1,
+                            sizeof(*result->values));
+    result->stats = calloc(n_points * sweep->n_metrics,
+                           sizeof(*result->stats));
+    result->rc = calloc(n_points, sizeof(*result->rc));
+    if (settings == NULL || results == NULL || result->values == NULL ||
+        result->stats == NULL || result->rc == NULL)
+    {
+        rc = TE_RC(TE_TAPI, TE_ENOMEM);
+        goto out;
+    }
+    result->n_points = n_points;
+
+    for (point = 0; point < n_points; point++)
+    {
+        values = &result->values[point * sweep->n_params];
+
+        /* Points are enumerated with the last parameter changing first */
+        if (point > 0)
+        {
+            memcpy(values, values - sweep->n_params,
+                   sweep->n_params * sizeof(*values));
+            for (i = sweep->n_params; i-- > 0; )
+            {
+                if (++values[i] < n_values[i])
+                    break;
+                values[i] = 0;
+            }
+        }
+
+        RING("Sweep point %u/%u", point + 1, n_points);
+        result->rc[point] = sweep_point_run(sweep, values, settings,
+                                            results,
+                                            &result->stats[point *
+                                                           sweep->n_metrics]);
+        if (first_rc == 0)
+            first_rc = result->rc[point];
+    }
+
+out:
+    free(n_values);
+    free(settings);
+    free(results);
+    if (rc != 0)
+    {
+        libts_sweep_result_free(result);
+        return rc;
+    }
+
+    return first_rc;
+}
+
+/* See description in lib-ts_sweep.h */
+te_errno
+libts_sweep_result_to_str(const libts_sweep *sweep,
+                          const libts_sweep_result *result, te_string *str)
+{
+    const libts_sweep_stats    *stats;
+    unsigned int                point;
+    unsigned int                i;
+    te_errno                    rc = 0;
+
+    for (i = 0; i < sweep->n_params && rc == 0; i++)
+        rc = te_string_append(str, "%s\t", sweep->params[i].name);
+    for (i = 0; i < sweep->n_metrics && rc == 0; i++)
+    {
+        rc = te_string_append(str, "%s_mean\t%s_stddev\t%s_min\t%s_max\t",
+                              sweep->metrics[i], sweep->metrics[i],
+                              sweep->metrics[i], sweep->metrics[i]);
+    }
+    if (rc == 0)
+        rc = te_string_append(str, "runs\tstatus\n");
+
+    for (point = 0; point < result->n_points && rc == 0; point++)
+    {
+        rc = sweep_point_to_str(sweep,
+                                &result->values[point * sweep->n_params],
+                                "\t", FALSE, str);
+        if (rc == 0 && sweep->n_params > 0)
+            rc = te_string_append(str, "\t");
+
+        stats = &result->stats[point * sweep->n_metrics];
+        for (i = 0; i < sweep->n_metrics && rc == 0; i++)
+        {
+            rc = te_string_append(str, "%.3f\t%.3f\t%.3f\t%.3f\t",
+                                  stats[i].mean, stats[i].stddev,
+                                  stats[i].min, stats[i].max);
+        }
+        if (rc == 0)
+        {
+            rc = te_string_append(str, "%u/%u\t%s\n", stats[0].n,
+                                  sweep->reruns,
+                                  result->rc[point] == 0 ? "OK" : "FAILED");
+        }
+    }
+
+    return rc;
+}
+
+/* See description in lib-ts_sweep.h */
+void
+libts_sweep_result_log(const libts_sweep *sweep,
+                       const libts_sweep_result *result)
+{
+    te_string str = TE_STRING_INIT;
+
+    if (libts_sweep_result_to_str(sweep, result, &str) == 0)
+        RING("Parameter sweep results on %s:\n%s", sweep->ta, str.ptr);
+    else
+        ERROR("Failed to format parameter sweep results");
+
+    te_string_free(&str);
+}
+
+/* See description in lib-ts_sweep.h */
+void
+libts_sweep_result_free(libts_sweep_result *result)
+{
+    free(result->values);
+    free(result->stats);
+    free(result->rc);
+    memset(result, 0, sizeof(*result));
+}
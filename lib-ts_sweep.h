@@ -0,0 +1,122 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Parameter sweep API
+ *
+ * Runner of a measurement over a grid of Onload/ZF tuning parameters
+ * values. Every point of the grid is applied with the tuning API (see
+ * lib-ts_tune.h), the measurement is repeated the requested number of
+ * times and the results of all points are gathered into one table.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_SWEEP_H__
+#define __ONLOAD_LIB_TS_SWEEP_H__
+
+#include "te_errno.h"
+#include "te_string.h"
+#include "lib-ts_tune.h"
+
+/** Swept parameter */
+typedef struct libts_sweep_param {
+    libts_tune_kind      kind;      /**< Kind of the parameter */
+    const char          *name;      /**< Variable name or ZF_ATTR key */
+    const char * const  *values;    /**< Values, terminated by @c NULL */
+} libts_sweep_param;
+
+/**
+ * Measurement function. It is called when the parameters of a point
+ * are applied with libts_tune_apply(), so processes started by the agent
+ * after that (e.g. RPC servers created by the function) use them.
+ * Processes which are already running are not affected, so the function
+ * should start processes which should use the parameters itself.
+ *
+ * @param arg       Measurement argument.
+ * @param results   Where to put values of metrics.
+ *
+ * @return Status code.
+ */
+typedef te_errno (*libts_sweep_measure)(void *arg, double *results);
+
+/** Parameter sweep */
+typedef struct libts_sweep {
+    const char                 *ta;         /**< Agent name */
+    const libts_sweep_param    *params;     /**< Swept parameters */
+    unsigned int                n_params;   /**< Number of parameters */
+    const char * const         *metrics;    /**< Names of metrics */
+    unsigned int                n_metrics;  /**< Number of metrics */
+    unsigned int                reruns;     /**< Number of measurements
+                                                 in every point */
+    libts_sweep_measure         measure;    /**< Measurement function */
+    void                       *arg;        /**< Measurement argument */
+} libts_sweep;
+
+/** Statistics of a metric in a point */
+typedef struct libts_sweep_stats {
+    unsigned int    n;          /**< Number of successful measurements */
+    double          mean;       /**< Mean value */
+    double          stddev;     /**< Sample standard deviation */
+    double          min;        /**< Minimum value */
+    double          max;        /**< Maximum value */
+} libts_sweep_stats;
+
+/** Results of a parameter sweep */
+typedef struct libts_sweep_result {
+    unsigned int        n_points;   /**< Number of points */
+    unsigned int       *values;     /**< Indexes of parameter values of
+                                         every point (@a n_params per
+                                         point) */
+    libts_sweep_stats  *stats;      /**< Statistics of every metric in
+                                         every point (@a n_metrics per
+                                         point) */
+    te_errno           *rc;         /**< Status of the last failed
+                                         measurement of every point */
+} libts_sweep_result;
+
+/**
+ * Run a measurement in every point of the parameters grid. Parameters
+ * are reverted after every point. Measurements of a point are done in
+ * a quiet console window (see lib-ts_loglevel.h).
+ *
+ * @param sweep     Parameter sweep.
+ * @param result    Where to put results (should be released with
+ *                  libts_sweep_result_free()).
+ *
+ * @return Status code of the first failure, the results of other
+ *         points are gathered anyway.
+ */
+extern te_errno libts_sweep_run(const libts_sweep *sweep,
+                                libts_sweep_result *result);
+
+/**
+ * Append results of a parameter sweep as a table with a line per point
+ * and columns separated by tabs.
+ *
+ * @param sweep     Parameter sweep.
+ * @param result    Results.
+ * @param str       Where to append the table.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_sweep_result_to_str(const libts_sweep *sweep,
+                                          const libts_sweep_result *result,
+                                          te_string *str);
+
+/**
+ * Log results of a parameter sweep.
+ *
+ * @param sweep     Parameter sweep.
+ * @param result    Results.
+ */
+extern void libts_sweep_result_log(const libts_sweep *sweep,
+                                   const libts_sweep_result *result);
+
+/**
+ * Release results of a parameter sweep.
+ *
+ * @param result    Results.
+ */
+extern void libts_sweep_result_free(libts_sweep_result *result);
+
+#endif /* !__ONLOAD_LIB_TS_SWEEP_H__ */
@@ -0,0 +1,253 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Parameter sweep API unit test
+ *
+ * Checks of statistics of metrics, of the order of grid points and of
+ * failed measurements. Tuning API is faked.
+ *
+ * @author agent <agent@local>
+ */
+
+#include "lib-ts_sweep.c"
+#include "lib-ts_unit.h"
+
+DEFINE_LGR_ENTITY("libts_sweep_test");
+
+/** Settings applied by the fake tuning API, a line per point */
+static te_string applied = TE_STRING_INIT;
+
+/** Number of reverted points */
+static unsigned int reverted;
+
+/* Fake of the tuning API function */
+te_errno
+libts_tune_apply(const char *ta, const libts_tune_profile *profile,
+                 libts_tune_backup *backup)
+{
+    unsigned int i;
+
+    LIBTS_UNIT_CHECK(strcmp(ta, "Agt_A") == 0);
+    for (i = 0; i < profile->n_settings; i++)
+    {
+        LIBTS_UNIT_CHECK(profile->settings[i].kind == LIBTS_TUNE_ENV);
+        te_string_append(&applied, "%s%s=%s", i == 0 ? "" : ",",
+                         profile->settings[i].name,
+                         profile->settings[i].value);
+    }
+    te_string_append(&applied, "\n");
+
+    return 0;
+}
+
+/* Fake of the tuning API function */
+te_errno
+libts_tune_revert(libts_tune_backup *backup)
+{
+    reverted++;
+    return 0;
+}
+
+/* Fake of the console log level API function */
+te_errno
+libts_loglevel_quiet_begin(const char *fmt, ...)
+{
+    return 0;
+}
+
+/* Fake of the console log level API function */
+te_errno
+libts_loglevel_quiet_end(te_bool failed)
+{
+    return 0;
+}
+
+/** Values of the first metric returned by measurements of a point */
+static const double lat_values[] = { 10, 12, 17 };
+
+/** Measurement state */
+typedef struct test_measure {
+    unsigned int    calls;      /**< Number of calls */
+    unsigned int    fail_call;  /**< Number of the call to fail
+                                     (from 1) or @c 0 */
+} test_measure;
+
+/**
+ * Measurement function: the first metric takes values from
+ * @p lat_values plus the point number times 100, the second one is
+ * constant.
+ *
+ * @param arg       Measurement state.
+ * @param results   Where to put values of metrics.
+ *
+ * @return Status code.
+ */
+static te_errno
+measure(void *arg, double *results)
+{
+    test_measure   *state = arg;
+    unsigned int    point = state->calls / TE_ARRAY_LEN(lat_values);
+    unsigned int    run = state->calls % TE_ARRAY_LEN(lat_values);
+
+    state->calls++;
+    if (state->calls == state->fail_call)
+    {
+        results[0] = 1e9;
+        return TE_RC(TE_TAPI, TE_ETIMEDOUT);
+    }
+
+    results[0] = lat_values[run] + point * 100;
+    results[1] = 5;
+    return 0;
+}
+
+/** Values of the first parameter */
+static const char * const poll_values[] = { "0", "100000", NULL };
+
+/** Values of the second parameter */
+static const char * const spin_values[] = { "0", "1", "2", NULL };
+
+/** Swept parameters */
+static const libts_sweep_param params[] = {
+    { LIBTS_TUNE_ENV, "EF_POLL_USEC", poll_values },
+    { LIBTS_TUNE_ENV, "EF_INT_DRIVEN", spin_values },
+};
+
+/** Metrics */
+static const char * const metrics[] = { "lat", "cpu" };
+
+/**
+ * Check statistics of every point and the order of points.
+ */
+static void
+test_grid(void)
+{
+    static const char  *header = "EF_POLL_USEC\tEF_INT_DRIVEN\tlat_mean\t"
+                                 "lat_stddev\tlat_min\tlat_max\t"
+                                 "cpu_mean\tcpu_stddev\tcpu_min\t"
+                                 "cpu_max\truns\tstatus\n";
+    test_measure        state = { 0, 0 };
+    libts_sweep         sweep = { "Agt_A", params, TE_ARRAY_LEN(params),
+                                  metrics, TE_ARRAY_LEN(metrics),
+                                  TE_ARRAY_LEN(lat_values), measure,
+                                  &state };
+    libts_sweep_result  result;
+    te_string           table = TE_STRING_INIT;
+    unsigned int        point;
+    libts_sweep_stats  *lat;
+    libts_sweep_stats  *cpu;
+
+    te_string_free(&applied);
+    reverted = 0;
+    LIBTS_UNIT_CHECK(libts_sweep_run(&sweep, &result) == 0);
+
+    LIBTS_UNIT_CHECK(result.n_points == 6);
+    LIBTS_UNIT_CHECK(reverted == 6);
+    LIBTS_UNIT_CHECK(state.calls == 18);
+    LIBTS_UNIT_CHECK(applied.ptr != NULL &&
+                     strcmp(applied.ptr,
+                            "EF_POLL_USEC=0,EF_INT_DRIVEN=0\n"
+                            "EF_POLL_USEC=0,EF_INT_DRIVEN=1\n"
+                            "EF_POLL_USEC=0,EF_INT_DRIVEN=2\n"
+                            "EF_POLL_USEC=100000,EF_INT_DRIVEN=0\n"
+                            "EF_POLL_USEC=100000,EF_INT_DRIVEN=1\n"
+                            "EF_POLL_USEC=100000,EF_INT_DRIVEN=2\n") == 0);
+
+    for (point = 0; point < result.n_points; point++)
+    {
+        lat = &result.stats[point * 2];
+        cpu = &result.stats[point * 2 + 1];
+
+        LIBTS_UNIT_CHECK(result.values[point * 2] == point / 3);
+        LIBTS_UNIT_CHECK(result.values[point * 2 + 1] == point % 3);
+        LIBTS_UNIT_CHECK(result.rc[point] == 0);
+        LIBTS_UNIT_CHECK(lat->n == 3);
+        LIBTS_UNIT_CHECK_DOUBLE(lat->mean, 13 + point * 100, 1e-9);
+        LIBTS_UNIT_CHECK_DOUBLE(lat->stddev, sqrt(13), 1e-9);
+        LIBTS_UNIT_CHECK_DOUBLE(lat->min, 10 + point * 100, 1e-9);
+        LIBTS_UNIT_CHECK_DOUBLE(lat->max, 17 + point * 100, 1e-9);
+        LIBTS_UNIT_CHECK_DOUBLE(cpu->mean, 5, 1e-9);
+        LIBTS_UNIT_CHECK_DOUBLE(cpu->stddev, 0, 1e-9);
+    }
+
+    LIBTS_UNIT_CHECK(libts_sweep_result_to_str(&sweep, &result,
+                                               &table) == 0);
+    LIBTS_UNIT_CHECK(strncmp(table.ptr, header, strlen(header)) == 0);
+    LIBTS_UNIT_CHECK(strstr(table.ptr,
+                            "\n100000\t2\t513.000\t3.606\t510.000\t"
+                            "517.000\t5.000\t0.000\t5.000\t5.000\t3/3\t"
+                            "OK\n") != NULL);
+
+    te_string_free(&table);
+    libts_sweep_result_free(&result);
+}
+
+/**
+ * Check that a failed measurement is excluded from statistics and the
+ * point is reported as failed, while other points are measured.
+ */
+static void
+test_failure(void)
+{
+    test_measure        state = { 0, 2 };
+    libts_sweep         sweep = { "Agt_A", params, 1, metrics, 1,
+                                  TE_ARRAY_LEN(lat_values), measure,
+                                  &state };
+    libts_sweep_result  result;
+    te_string           table = TE_STRING_INIT;
+
+    te_string_free(&applied);
+    reverted = 0;
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(libts_sweep_run(&sweep, &result))
+                     == TE_ETIMEDOUT);
+
+    LIBTS_UNIT_CHECK(result.n_points == 2);
+    LIBTS_UNIT_CHECK(reverted == 2);
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(result.rc[0]) == TE_ETIMEDOUT);
+    LIBTS_UNIT_CHECK(result.rc[1] == 0);
+    LIBTS_UNIT_CHECK(result.stats[0].n == 2);
+    LIBTS_UNIT_CHECK_DOUBLE(result.stats[0].mean, 13.5, 1e-9);
+    LIBTS_UNIT_CHECK_DOUBLE(result.stats[0].max, 17, 1e-9);
+    LIBTS_UNIT_CHECK(result.stats[1].n == 3);
+
+    LIBTS_UNIT_CHECK(libts_sweep_result_to_str(&sweep, &result,
+                                               &table) == 0);
+    LIBTS_UNIT_CHECK(strstr(table.ptr, "\t2/3\tFAILED\n") != NULL);
+
+    te_string_free(&table);
+    libts_sweep_result_free(&result);
+
+    sweep.reruns = 0;
+    LIBTS_UNIT_CHECK(TE_RC_GET_ERROR(libts_sweep_run(&sweep, &result))
+                     == TE_EINVAL);
+}
+
+/**
+ * Check statistics of a single value.
+ */
+static void
+test_stats_single(void)
+{
+    libts_sweep_stats stats;
+
+    memset(&stats, 0, sizeof(stats));
+    sweep_stats_add(&stats, -2.5);
+    sweep_stats_finish(&stats);
+
+    LIBTS_UNIT_CHECK(stats.n == 1);
+    LIBTS_UNIT_CHECK_DOUBLE(stats.mean, -2.5, 1e-12);
+    LIBTS_UNIT_CHECK_DOUBLE(stats.stddev, 0, 1e-12);
+    LIBTS_UNIT_CHECK_DOUBLE(stats.min, -2.5, 1e-12);
+    LIBTS_UNIT_CHECK_DOUBLE(stats.max, -2.5, 1e-12);
+}
+
+int
+main(void)
+{
+    test_grid();
+    test_failure();
+    test_stats_single();
+
+    te_string_free(&applied);
+    return libts_unit_result();
+}
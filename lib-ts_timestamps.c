@@ -10,9 +10,13 @@
 
 #define TE_LGR_USER     "Libts Timestamps"
 
+#include <math.h>
+#include <time.h>
+
 #include "lib-ts.h"
 #include "lib-ts_netns.h"
 #include "lib-ts_timestamps.h"
+#include "lib-ts_timing.h"
 #include "tapi_cfg.h"
 #include "tapi_rpc_socket.h"
 #include "tapi_rpc_unistd.h"
@@ -23,6 +27,712 @@
 #include "tapi_rpcsock_macros.h"
 #include "rcf_api.h"
 
+/** Maximum time to wait for a daemon to stop, ms */
+#define DAEMON_STOP_TIMEOUT 5000
+/** Interval between checks whether a daemon is stopped, ms */
+#define DAEMON_STOP_INTERVAL 100
+
+/**
+ * Get path to phc_ctl tool on agents.
+ *
+ * @return Path to the tool.
+ */
+static const char *
+phc_ctl_path(void)
+{
+    const char *path = getenv("SFC_ONLOAD_PHC_CTL");
+
+    return path == NULL || path[0] == '\0' ? "phc_ctl" : path;
+}
+
+/**
+ * Append phc_ctl location and optionally an interface name quoted for
+ * shell.
+ *
+ * @param str       Where to append.
+ * @param ifname    Interface name or @c NULL.
+ *
+ * @return Status code.
+ */
+static te_errno
+phc_ctl_args(te_string *str, const char *ifname)
+{
+    te_errno rc;
+
+    rc = libts_shell_quote(str, phc_ctl_path());
+    if (rc == 0 && ifname != NULL)
+    {
+        rc = te_string_append(str, " ");
+        if (rc == 0)
+            rc = libts_shell_quote(str, ifname);
+    }
+
+    return rc;
+}
+
+/**
+ * Wait until no process with the given name is running on the agent.
+ *
+ * @param ta        Test agent name.
+ * @param name      Process name.
+ *
+ * @return Status code.
+ */
+static te_errno
+wait_process_stop(const char *ta, const char *name)
+{
+    double      start = libts_monotonic_ms();
+    int         status;
+    te_errno    rc;
+
+    for (;;)
+    {
+        rc = libts_ta_shell(ta, &status, "pgrep -x %s >/dev/null", name);
+        if (rc != 0)
+            return rc;
+        if (status != 0)
+            break;
+
+        if (libts_monotonic_ms() - start > DAEMON_STOP_TIMEOUT)
+        {
+            ERROR("%s is still running on %s", name, ta);
+            return TE_RC(TE_TAPI, TE_ETIMEDOUT);
+        }
+        MSLEEP(DAEMON_STOP_INTERVAL);
+    }
+
+    RING("%s is stopped on %s in %llu ms", name, ta,
+         (unsigned long long)(libts_monotonic_ms() - start));
+    return 0;
+}
+
+/**
+ * Reduce NIC clock offset modulo one second to ignore whole seconds
+ * difference between TAI and UTC time scales.
+ *
+ * @param offset    Offset, ns.
+ *
+ * @return Offset in the range [-0.5 s, 0.5 s], ns.
+ */
+static int64_t
+phc_offset_fold(int64_t offset)
+{
+    offset %= 1000000000LL;
+    if (offset > 500000000LL)
+        offset -= 1000000000LL;
+    else if (offset < -500000000LL)
+        offset += 1000000000LL;
+
+    return offset;
+}
+
+/* See description in lib-ts_timestamps.h */
+void
+libts_timestamps_sync_params_init(libts_timestamps_sync_params *params)
+{
+    params->threshold =
+        libts_getenv_uint("SFC_ONLOAD_SFPTPD_SYNC_THRESHOLD", 0, UINT_MAX,
+                          LIBTS_TIMESTAMPS_SYNC_THRESHOLD_DEF);
+    params->samples =
+        libts_getenv_uint("SFC_ONLOAD_SFPTPD_SYNC_SAMPLES", 1, UINT_MAX,
+                          LIBTS_TIMESTAMPS_SYNC_SAMPLES_DEF);
+    params->interval =
+        libts_getenv_uint("SFC_ONLOAD_SFPTPD_SYNC_INTERVAL", 1, UINT_MAX,
+                          LIBTS_TIMESTAMPS_SYNC_INTERVAL_DEF);
+    params->timeout =
+        libts_getenv_uint("SFC_ONLOAD_SFPTPD_SYNC_TIMEOUT", 0, UINT_MAX,
+                          LIBTS_TIMESTAMPS_SYNC_TIMEOUT_DEF);
+}
+
+/* See description in lib-ts_timestamps.h */
+te_errno
+libts_timestamps_get_phc_offset(const char *ta, const char *ifname,
+                                int64_t *offset, double *freq)
+{
+    static const char *offset_str = "offset from CLOCK_REALTIME is ";
+    static const char *freq_str = "frequency offset is ";
+
+    te_string   args = TE_STRING_INIT;
+    char       *out = NULL;
+    char       *p;
+    long long   val;
+    te_errno    rc;
+
+    rc = phc_ctl_args(&args, ifname);
+    if (rc == 0)
+    {
+        rc = libts_ta_shell_get(ta, &out, "%s cmp freq 2>&1",
+                                args.ptr);
+    }
+    te_string_free(&args);
+    if (rc != 0)
+        return rc;
+
+    p = strstr(out, offset_str);
+    if (p == NULL || sscanf(p + strlen(offset_str), "%lld", &val) != 1)
+    {
+        ERROR("Failed to get PHC offset of %s on %s: %s", ifname, ta, out);
+        free(out);
+        return TE_RC(TE_TAPI, TE_EPROTO);
+    }
+
+    *offset = phc_offset_fold(val);
+
+    if (freq != NULL)
+    {
+        p = strstr(out, freq_str);
+        if (p == NULL || sscanf(p + strlen(freq_str), "%lf", freq) != 1)
+        {
+            ERROR("Failed to get PHC frequency of %s on %s: %s",
+                  ifname, ta, out);
+            free(out);
+            return TE_RC(TE_TAPI, TE_EPROTO);
+        }
+    }
+
+    free(out);
+    return 0;
+}
+
+/* See description in lib-ts_timestamps.h */
+void
+libts_timestamps_wait_sync(const libts_timestamps_sync_params *params)
+{
+    const char  *ifname = getenv("TE_ORIG_IUT_TST1");
+    libts_timestamps_sync_params def;
+    double       start = libts_monotonic_ms();
+    unsigned int in_sync = 0;
+    int64_t      offset = 0;
+    te_string    args = TE_STRING_INIT;
+    char        *ta = NULL;
+    int          status;
+    te_errno     rc;
+
+    if (params == NULL)
+    {
+        libts_timestamps_sync_params_init(&def);
+        params = &def;
+    }
+
+    if (ifname == NULL)
+        TEST_FAIL("environment value TE_ORIG_IUT_TST1 was not set");
+
+    CHECK_RC(libts_netns_get_sfc_ta(&ta));
+
+    rc = phc_ctl_args(&args, NULL);
+    if (rc == 0)
+    {
+        rc = libts_ta_shell(ta, &status, "command -v %s >/dev/null",
+                            args.ptr);
+    }
+    te_string_free(&args);
+    CHECK_RC(rc);
+    if (status != 0)
+    {
+        WARN("%s is not available on %s, clock synchronization cannot "
+             "be checked", phc_ctl_path(), ta);
+        VSLEEP(1, "waiting for sfptpd to synchronize clocks");
+        free(ta);
+        return;
+    }
+
+    for (;;)
+    {
+        if (!tapi_sfptpd_status(ta))
+            TEST_VERDICT("sfptpd is not running");
+
+        CHECK_RC(libts_timestamps_get_phc_offset(ta, ifname, &offset,
+                                                 NULL));
+        if (llabs(offset) <= (long long)params->threshold)
+            in_sync++;
+        else
+            in_sync = 0;
+
+        if (in_sync >= params->samples)
+            break;
+
+        if (libts_monotonic_ms() - start > params->timeout)
+        {
+            TEST_VERDICT("NIC clock of %s is not synchronized by sfptpd "
+                         "in %u ms, last offset is %lld ns", ifname,
+                         params->timeout, (long long)offset);
+        }
+        MSLEEP(params->interval);
+    }
+
+    RING("NIC clock of %s is synchronized in %llu ms, offset is %lld ns",
+         ifname, (unsigned long long)(libts_monotonic_ms() - start),
+         (long long)offset);
+    free(ta);
+}
+
+/** Location of the NIC clock sampler files on the agent */
+#define SAMPLER_PATH "/tmp/libts_phc_sampler"
+
+/**
+ * Shell script which samples the NIC clock offset and frequency
+ * adjustment and keeps the last samples in a file. Arguments are
+ * phc_ctl path, interface name, interval in seconds, number of
+ * samples to keep and samples file name.
+ */
+static const char *sampler_script =
+    "#!/bin/sh\n"
+    "n=0\n"
+    "while :; do\n"
+    "    out=$(\"$1\" \"$2\" cmp freq 2>&1)\n"
+    "    off=$(echo \"$out\" | sed -n "
+    "'s/.*offset from CLOCK_REALTIME is \\(-*[0-9]*\\).*/\\1/p')\n"
+    "    freq=$(echo \"$out\" | sed -n "
+    "'s/.*frequency offset is \\(-*[0-9.]*\\).*/\\1/p')\n"
+    "    if [ -n \"$off\" ]; then\n"
+    "        echo \"$(date +%s%N) $off ${freq:-0}\" >>\"$5\"\n"
+    "        n=$((n + 1))\n"
+    "        if [ $n -gt $4 ]; then\n"
+    "            tail -n $4 \"$5\" >\"$5.tmp\" && mv -f \"$5.tmp\" \"$5\"\n"
+    "            n=$4\n"
+    "        fi\n"
+    "    fi\n"
+    "    sleep $3\n"
+    "done\n";
+
+/** NIC clock sample */
+typedef struct clock_sample {
+    int64_t     time;       /**< Sampling time, ns */
+    int64_t     offset;     /**< Clock offset, ns */
+    double      freq;       /**< Frequency adjustment, ppb */
+} clock_sample;
+
+/**
+ * Compare two 64-bit integers for qsort().
+ */
+static int
+int64_cmp(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * Get percentile of sorted values using the nearest rank method.
+ *
+ * @param values    Sorted values.
+ * @param n         Number of values.
+ * @param p         Percentile in tenths of percent (0 - 1000).
+ *
+ * @return Value of the percentile.
+ */
+static int64_t
+percentile(const int64_t *values, unsigned int n, unsigned int p)
+{
+    unsigned int rank = ((uint64_t)n * p + 999) / 1000;
+
+    return values[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * Calculate summary of NIC clock samples.
+ *
+ * @param samples   Samples in time order.
+ * @param n         Number of samples.
+ * @param stats     Where to put the summary.
+ *
+ * @return Status code.
+ */
+static te_errno
+clock_stats_calc(const clock_sample *samples, unsigned int n,
+                 libts_timestamps_clock_stats *stats)
+{
+    int64_t        *abs_offsets;
+    double          sum = 0;
+    double          tau;
+    unsigned int    i;
+
+    memset(stats, 0, sizeof(*stats));
+    if (n == 0)
+        return 0;
+
+    abs_offsets = calloc(n, sizeof(*abs_offsets));
+    if (abs_offsets == NULL)
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+
+    stats->n_samples = n;
+    stats->duration = (samples[n - 1].time - samples[0].time) / 1e9;
+    stats->offset_min = stats->offset_max = samples[0].offset;
+    stats->freq_min = stats->freq_max = samples[0].freq;
+    for (i = 0; i < n; i++)
+    {
+        if (samples[i].offset < stats->offset_min)
+            stats->offset_min = samples[i].offset;
+        if (samples[i].offset > stats->offset_max)
+            stats->offset_max = samples[i].offset;
+        if (samples[i].freq < stats->freq_min)
+            stats->freq_min = samples[i].freq;
+        if (samples[i].freq > stats->freq_max)
+            stats->freq_max = samples[i].freq;
+        sum += samples[i].offset;
+        abs_offsets[i] = llabs(samples[i].offset);
+    }
+    stats->offset_mean = sum / n;
+
+    qsort(abs_offsets, n, sizeof(*abs_offsets), int64_cmp);
+    stats->abs_offset_p50 = percentile(abs_offsets, n, 500);
+    stats->abs_offset_p90 = percentile(abs_offsets, n, 900);
+    stats->abs_offset_p99 = percentile(abs_offsets, n, 990);
+    free(abs_offsets);
+
+    /*
+     * Allan deviation at the sampling interval from the time error
+     * (phase) data: sqrt(sum((x[i+2] - 2x[i+1] + x[i])^2) /
+     * (2 * tau^2 * (n - 2))).
+     */
+    if (n > 2 && stats->duration > 0)
+    {
+        tau = (samples[n - 1].time - samples[0].time) / (double)(n - 1);
+        sum = 0;
+        for (i = 0; i + 2 < n; i++)
+        {
+            double d = samples[i + 2].offset - 2. * samples[i + 1].offset +
+                       samples[i].offset;
+
+            sum += d * d;
+        }
+        stats->adev = sqrt(sum / (2. * tau * tau * (n - 2))) * 1e9;
+    }
+
+    return 0;
+}
+
+/* See description in lib-ts_timestamps.h */
+void
+libts_timestamps_sampler_start(unsigned int interval, unsigned int size)
+{
+    const char *ifname = getenv("TE_ORIG_IUT_TST1");
+    te_string   args = TE_STRING_INIT;
+    char       *ta = NULL;
+    te_errno    rc;
+
+    if (ifname == NULL)
+        TEST_FAIL("environment value TE_ORIG_IUT_TST1 was not set");
+    if (interval == 0 || size == 0)
+        TEST_FAIL("Invalid NIC clock sampler interval or size");
+
+    CHECK_RC(libts_timestamps_sampler_stop());
+    CHECK_RC(libts_netns_get_sfc_ta(&ta));
+
+    CHECK_RC(tapi_file_create_ta(ta, SAMPLER_PATH ".sh", "%s",
+                                 sampler_script));
+    rc = phc_ctl_args(&args, ifname);
+    if (rc == 0)
+    {
+        rc = libts_ta_shell(ta, NULL,
+                            "rm -f " SAMPLER_PATH ".dat; "
+                            "nohup sh " SAMPLER_PATH ".sh %s %u.%03u %u "
+                            SAMPLER_PATH ".dat >/dev/null 2>&1 & "
+                            "echo $! >" SAMPLER_PATH ".pid",
+                            args.ptr, interval / 1000, interval % 1000,
+                            size);
+    }
+    te_string_free(&args);
+    CHECK_RC(rc);
+
+    RING("NIC clock sampler is started on %s: interval %u ms, %u samples",
+         ta, interval, size);
+    free(ta);
+}
+
+/* See description in lib-ts_timestamps.h */
+te_errno
+libts_timestamps_sampler_get_stats(libts_timestamps_clock_stats *stats)
+{
+    clock_sample   *samples = NULL;
+    unsigned int    n = 0;
+    unsigned int    max = 0;
+    char           *ta = NULL;
+    char           *buf = NULL;
+    char           *line;
+    char           *saveptr = NULL;
+    long long       time;
+    long long       offset;
+    double          freq;
+    te_errno        rc;
+
+    rc = libts_netns_get_sfc_ta(&ta);
+    if (rc != 0)
+        return rc;
+
+    rc = libts_ta_shell_get(ta, &buf, "cat " SAMPLER_PATH ".dat");
+    free(ta);
+    if (rc != 0)
+        return rc;
+
+    for (line = strtok_r(buf, "\n", &saveptr); line != NULL;
+         line = strtok_r(NULL, "\n", &saveptr))
+    {
+        if (sscanf(line, "%lld %lld %lf", &time, &offset, &freq) != 3)
+            continue;
+
+        if (n == max)
+        {
+            clock_sample *tmp;
+
+            max = max == 0 ? LIBTS_TIMESTAMPS_SAMPLER_SIZE_DEF : max * 2;
+            tmp = realloc(samples, max * sizeof(*samples));
+            if (tmp == NULL)
+            {
+                free(samples);
+                free(buf);
+                return TE_RC(TE_TAPI, TE_ENOMEM);
+            }
+            samples = tmp;
+        }
+        samples[n].time = time;
+        samples[n].offset = phc_offset_fold(offset);
+        samples[n].freq = freq;
+        n++;
+    }
+    free(buf);
+
+    rc = clock_stats_calc(samples, n, stats);
+    free(samples);
+
+    return rc;
+}
+
+/* See description in lib-ts_timestamps.h */
+void
+libts_timestamps_clock_stats_log(const libts_timestamps_clock_stats *stats)
+{
+    RING("NIC clock quality over %.1f s (%u samples):\n"
+         "offset min/mean/max: %lld / %.1f / %lld ns\n"
+         "absolute offset p50/p90/p99: %lld / %lld / %lld ns\n"
+         "frequency adjustment min/max: %.3f / %.3f ppb\n"
+         "Allan deviation: %.3f ppb",
+         stats->duration, stats->n_samples,
+         (long long)stats->offset_min, stats->offset_mean,
+         (long long)stats->offset_max, (long long)stats->abs_offset_p50,
+         (long long)stats->abs_offset_p90, (long long)stats->abs_offset_p99,
+         stats->freq_min, stats->freq_max, stats->adev);
+}
+
+/* See description in lib-ts_timestamps.h */
+te_errno
+libts_timestamps_sampler_stop(void)
+{
+    char       *ta = NULL;
+    te_errno    rc;
+
+    rc = libts_netns_get_sfc_ta(&ta);
+    if (rc != 0)
+        return rc;
+
+    rc = libts_ta_shell(ta, NULL,
+                        "if [ -f " SAMPLER_PATH ".pid ]; then "
+                        "kill $(cat " SAMPLER_PATH ".pid) 2>/dev/null; "
+                        "rm -f " SAMPLER_PATH ".pid; fi");
+    free(ta);
+
+    return rc;
+}
+
+/** Size of buffer for control messages with timestamps */
+#define TS_CMSG_BUF_LEN 512
+
+/**
+ * Receive a packet or its TX timestamp from error queue and get
+ * hardware timestamp of it.
+ *
+ * @param rpcs      RPC server.
+ * @param s         Socket.
+ * @param errqueue  Receive from error queue if @c TRUE.
+ * @param buf       Buffer for the packet data.
+ * @param len       Buffer length.
+ * @param timeout   Time to wait for the packet, ms.
+ * @param ts        Where to put the timestamp, ns.
+ *
+ * @return Received data length or @c -1 if there is no packet or it has
+ *         no hardware timestamp.
+ */
+static ssize_t
+recv_hw_ts(rcf_rpc_server *rpcs, int s, te_bool errqueue, void *buf,
+           size_t len, unsigned int timeout, int64_t *ts)
+{
+    struct rpc_pollfd   pfd = { .fd = s,
+                                .events = errqueue ? 0 : RPC_POLLIN };
+    char                cmsg_buf[TS_CMSG_BUF_LEN];
+    struct rpc_iovec    iov = { .iov_base = buf, .iov_len = len,
+                                .iov_rlen = len };
+    rpc_msghdr          msg;
+    struct msghdr       hmsg;
+    struct cmsghdr     *cmsg;
+    struct timespec    *hw_ts;
+    ssize_t             rc;
+
+    if (rpc_poll(rpcs, &pfd, 1, timeout) <= 0)
+        return -1;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = msg.msg_riovlen = 1;
+    msg.msg_control = cmsg_buf;
+    msg.msg_controllen = sizeof(cmsg_buf);
+    msg.msg_cmsghdr_num = 2;
+
+    RPC_AWAIT_ERROR(rpcs);
+    rc = rpc_recvmsg(rpcs, s, &msg, RPC_MSG_DONTWAIT |
+                                    (errqueue ? RPC_MSG_ERRQUEUE : 0));
+    if (rc < 0)
+        return -1;
+
+    /* Control messages are converted to the host representation */
+    memset(&hmsg, 0, sizeof(hmsg));
+    hmsg.msg_control = msg.msg_control;
+    hmsg.msg_controllen = msg.msg_controllen;
+    for (cmsg = CMSG_FIRSTHDR(&hmsg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&hmsg, cmsg))
+    {
+        if (cmsg->cmsg_level != SOL_SOCKET ||
+            cmsg->cmsg_type != SO_TIMESTAMPING)
+            continue;
+
+        /* The third timestamp is the raw hardware one */
+        hw_ts = (struct timespec *)CMSG_DATA(cmsg);
+        if (hw_ts[2].tv_sec == 0 && hw_ts[2].tv_nsec == 0)
+            break;
+
+        *ts = (int64_t)hw_ts[2].tv_sec * 1000000000LL + hw_ts[2].tv_nsec;
+        return rc;
+    }
+
+    return -1;
+}
+
+/* See description in lib-ts_timestamps.h */
+void
+libts_timestamps_measure_latency(rcf_rpc_server *pco_iut,
+                                 rcf_rpc_server *pco_tst,
+                                 const struct sockaddr *iut_addr,
+                                 const struct sockaddr *tst_addr,
+                                 const libts_timestamps_latency_params *params,
+                                 libts_timestamps_latency *result)
+{
+    int          iut_s = -1;
+    int          tst_s = -1;
+    char        *tx_buf = NULL;
+    char        *rx_buf = NULL;
+    size_t       size = params->size;
+    int64_t     *sorted;
+    int64_t      tx_ts;
+    int64_t      rx_ts;
+    uint32_t     seq;
+    double       sum = 0;
+    ssize_t      len;
+    unsigned int i;
+
+    memset(result, 0, sizeof(*result));
+
+    if (size < sizeof(seq))
+        size = sizeof(seq);
+    tx_buf = calloc(1, size);
+    rx_buf = calloc(1, size);
+    result->samples = calloc(params->n_packets + 1,
+                             sizeof(*result->samples));
+    if (tx_buf == NULL || rx_buf == NULL || result->samples == NULL)
+        TEST_FAIL("Memory allocation failure");
+
+    GEN_CONNECTION(pco_tst, pco_iut, RPC_SOCK_DGRAM, RPC_PROTO_DEF,
+                   tst_addr, iut_addr, &tst_s, &iut_s);
+
+    rpc_setsockopt_int(pco_iut, iut_s, RPC_SO_TIMESTAMPING,
+                       RPC_SOF_TIMESTAMPING_TX_HARDWARE |
+                       RPC_SOF_TIMESTAMPING_RAW_HARDWARE);
+    rpc_setsockopt_int(pco_tst, tst_s, RPC_SO_TIMESTAMPING,
+                       RPC_SOF_TIMESTAMPING_RX_HARDWARE |
+                       RPC_SOF_TIMESTAMPING_RAW_HARDWARE);
+
+    for (i = 0; i < params->n_packets; i++)
+    {
+        seq = i;
+        memcpy(tx_buf, &seq, sizeof(seq));
+        rpc_send(pco_iut, iut_s, tx_buf, size, 0);
+        result->n_sent++;
+
+        /*
+         * TX timestamp is requested before the next packet is sent,
+         * so timestamps are paired by the sending order.
+         */
+        if (recv_hw_ts(pco_iut, iut_s, TRUE, rx_buf, size,
+                       params->timeout, &tx_ts) < 0)
+        {
+            WARN("No TX hardware timestamp for packet %u", i);
+            tx_ts = -1;
+        }
+
+        /* Skip packets left from the previous iterations */
+        do {
+            len = recv_hw_ts(pco_tst, tst_s, FALSE, rx_buf, size,
+                             params->timeout, &rx_ts);
+            if (len >= (ssize_t)sizeof(seq))
+                memcpy(&seq, rx_buf, sizeof(seq));
+        } while (len >= (ssize_t)sizeof(seq) && seq < i);
+
+        if (len < (ssize_t)sizeof(seq) || seq != i)
+            WARN("No packet %u with RX hardware timestamp", i);
+        else if (tx_ts >= 0)
+            result->samples[result->n_samples++] = rx_ts - tx_ts;
+
+        if (params->interval > 0)
+            usleep(params->interval);
+    }
+
+    RPC_CLOSE(pco_iut, iut_s);
+    RPC_CLOSE(pco_tst, tst_s);
+    free(tx_buf);
+    free(rx_buf);
+
+    if (result->n_samples == 0)
+        TEST_VERDICT("No packets with both TX and RX hardware timestamps");
+
+    sorted = calloc(result->n_samples, sizeof(*sorted));
+    if (sorted == NULL)
+        TEST_FAIL("Memory allocation failure");
+    memcpy(sorted, result->samples, result->n_samples * sizeof(*sorted));
+    qsort(sorted, result->n_samples, sizeof(*sorted), int64_cmp);
+
+    for (i = 0; i < result->n_samples; i++)
+        sum += sorted[i];
+    result->mean = sum / result->n_samples;
+    result->min = sorted[0];
+    result->max = sorted[result->n_samples - 1];
+    result->p50 = percentile(sorted, result->n_samples, 500);
+    result->p99 = percentile(sorted, result->n_samples, 990);
+    result->p999 = percentile(sorted, result->n_samples, 999);
+    free(sorted);
+}
+
+/* See description in lib-ts_timestamps.h */
+void
+libts_timestamps_latency_log(const libts_timestamps_latency *result)
+{
+    RING("One-way latency by hardware timestamps (%u of %u packets):\n"
+         "min/mean/max: %lld / %.1f / %lld ns\n"
+         "p50/p99/p99.9: %lld / %lld / %lld ns",
+         result->n_samples, result->n_sent,
+         (long long)result->min, result->mean, (long long)result->max,
+         (long long)result->p50, (long long)result->p99,
+         (long long)result->p999);
+}
+
+/* See description in lib-ts_timestamps.h */
+void
+libts_timestamps_latency_free(libts_timestamps_latency *result)
+{
+    free(result->samples);
+    result->samples = NULL;
+    result->n_samples = 0;
+}
+
 /* See description in lib-ts_timestamps.h */
 void
 libts_timestamps_configure_sfptpd(void)
@@ -46,6 +756,7 @@ libts_timestamps_configure_sfptpd(void)
     if (ifname == NULL)
         TEST_FAIL("environment value TE_ORIG_IUT_TST1 was not set");
 
+    libts_timing_start("sfptpd_configure");
     CHECK_RC(libts_netns_get_sfc_ta(&ta));
 
     val_type = CVT_STRING;
@@ -54,7 +765,7 @@ libts_timestamps_configure_sfptpd(void)
     if ((rc = snprintf(dest, sizeof(dest), "%s/sfptpd", agt_dir)) < 0 ||
         rc > (int)sizeof(dest))
         TEST_FAIL("Failed to create string with sftpd destination");
-    CHECK_RC(rcf_ta_put_file(ta, 0, daemon, dest));
+    CHECK_RC(libts_put_file_ta(ta, daemon, dest));
     RING("Successful file transmission %s -> %s:%s", daemon, ta, dest);
 
     CHECK_RC(cfg_set_instance_fmt(CVT_STRING, dest,
@@ -66,7 +777,7 @@ libts_timestamps_configure_sfptpd(void)
         TEST_FAIL("Failed to create string with sftpd config destination");
     free(agt_dir);
 
-    CHECK_RC(rcf_ta_put_file(ta, 0, cfg, dest));
+    CHECK_RC(libts_put_file_ta(ta, cfg, dest));
     RING("Successful file transmission %s -> %s:%s", cfg, ta, dest);
 
     CHECK_RC(cfg_set_instance_fmt(CVT_STRING, dest,
@@ -74,6 +785,7 @@ libts_timestamps_configure_sfptpd(void)
 
     CHECK_RC(cfg_set_instance_fmt(CVT_STRING, ifname,
                                   "/agent:%s/sfptpd:/ifname:", ta));
+    libts_timing_stop();
 }
 
 /* See description in lib-ts_timestamps.h */
@@ -85,11 +797,27 @@ libts_timestamps_enable_sfptpd(rcf_rpc_server *pco_iut)
     /* Don't try to start SF PTP daemon if env ST_RUN_TS_NO_SFPTPD=1. */
     if (tapi_getenv_bool("ST_RUN_TS_NO_SFPTPD") == FALSE)
     {
+        libts_timing_start("sfptpd_enable");
         tapi_ntpd_disable(pco_iut);
-        VSLEEP(1, "waiting for ntpd stop");
+        CHECK_RC(wait_process_stop(pco_iut->ta, "ntpd"));
 
         CHECK_RC(libts_netns_get_sfc_ta(&ta_sfc));
         tapi_sfptpd_enable(ta_sfc);
+        free(ta_sfc);
+
+        libts_timestamps_wait_sync(NULL);
+
+        if (tapi_getenv_bool("SFC_ONLOAD_PHC_SAMPLER"))
+        {
+            libts_timestamps_sampler_start(
+                libts_getenv_uint("SFC_ONLOAD_PHC_SAMPLER_INTERVAL", 1,
+                                  UINT_MAX,
+                                  LIBTS_TIMESTAMPS_SAMPLER_INTERVAL_DEF),
+                libts_getenv_uint("SFC_ONLOAD_PHC_SAMPLER_SIZE", 1,
+                                  UINT_MAX,
+                                  LIBTS_TIMESTAMPS_SAMPLER_SIZE_DEF));
+        }
+        libts_timing_stop();
     }
 }
 
@@ -105,8 +833,18 @@ libts_timestamps_disable_sfptpd(rcf_rpc_server *pco_iut)
         if (!tapi_sfptpd_status(ta_sfc))
             TEST_VERDICT("sfptpd is not running");
 
+        if (tapi_getenv_bool("SFC_ONLOAD_PHC_SAMPLER"))
+        {
+            libts_timestamps_clock_stats stats;
+
+            CHECK_RC(libts_timestamps_sampler_stop());
+            if (libts_timestamps_sampler_get_stats(&stats) == 0)
+                libts_timestamps_clock_stats_log(&stats);
+        }
+
         tapi_sfptpd_disable(pco_iut->ta);
-        VSLEEP(1, "waiting for sfptpd stop");
+        CHECK_RC(wait_process_stop(ta_sfc, "sfptpd"));
+        free(ta_sfc);
 
         tapi_ntpd_enable(pco_iut);
     }
@@ -14,6 +14,203 @@
 #include "te_errno.h"
 #include "lib-ts.h"
 
+/** Default maximum PHC offset to consider it synchronized, ns */
+#define LIBTS_TIMESTAMPS_SYNC_THRESHOLD_DEF 10000
+/** Default number of consecutive samples within the threshold */
+#define LIBTS_TIMESTAMPS_SYNC_SAMPLES_DEF 3
+/** Default interval between samples, ms */
+#define LIBTS_TIMESTAMPS_SYNC_INTERVAL_DEF 200
+/** Default maximum time to wait for synchronization, ms */
+#define LIBTS_TIMESTAMPS_SYNC_TIMEOUT_DEF 30000
+
+/**
+ * Criteria of the NIC clock synchronization readiness.
+ */
+typedef struct libts_timestamps_sync_params {
+    unsigned int threshold;     /**< Maximum absolute offset, ns */
+    unsigned int samples;       /**< Number of consecutive samples
+                                     within the threshold */
+    unsigned int interval;      /**< Interval between samples, ms */
+    unsigned int timeout;       /**< Maximum time to wait, ms */
+} libts_timestamps_sync_params;
+
+/**
+ * Initialize clock synchronization readiness criteria with defaults
+ * overridden by environment variables SFC_ONLOAD_SFPTPD_SYNC_THRESHOLD,
+ * SFC_ONLOAD_SFPTPD_SYNC_SAMPLES, SFC_ONLOAD_SFPTPD_SYNC_INTERVAL and
+ * SFC_ONLOAD_SFPTPD_SYNC_TIMEOUT.
+ *
+ * @param params    Criteria to initialize.
+ */
+extern void libts_timestamps_sync_params_init(
+                                libts_timestamps_sync_params *params);
+
+/**
+ * Get offset of the NIC clock (PHC) from CLOCK_REALTIME and its
+ * frequency adjustment using phc_ctl tool (SFC_ONLOAD_PHC_CTL
+ * environment variable may specify another location of the tool).
+ *
+ * @note The offset is reduced modulo one second to ignore the whole
+ *       seconds difference between TAI and UTC time scales.
+ *
+ * @param ta        Test agent which controls the interface.
+ * @param ifname    Interface name.
+ * @param offset    Where to put the offset, ns.
+ * @param freq      Where to put the frequency adjustment, ppb
+ *                  (may be @c NULL).
+ *
+ * @return Status code.
+ */
+extern te_errno libts_timestamps_get_phc_offset(const char *ta,
+                                                const char *ifname,
+                                                int64_t *offset,
+                                                double *freq);
+
+/**
+ * Wait until sfptpd synchronizes the NIC clock of TE_ORIG_IUT_TST1
+ * interface, i.e. the clock offset stays within the threshold for
+ * the required number of consecutive samples. Test fails with verdict
+ * if it does not happen in time.
+ *
+ * @param params    Readiness criteria or @c NULL to use defaults.
+ */
+extern void libts_timestamps_wait_sync(
+                        const libts_timestamps_sync_params *params);
+
+/** Default interval between clock offset samples, ms */
+#define LIBTS_TIMESTAMPS_SAMPLER_INTERVAL_DEF 100
+/** Default number of clock offset samples kept on the agent */
+#define LIBTS_TIMESTAMPS_SAMPLER_SIZE_DEF 1024
+
+/**
+ * Summary of NIC clock quality samples.
+ */
+typedef struct libts_timestamps_clock_stats {
+    unsigned int    n_samples;      /**< Number of samples */
+    double          duration;       /**< Time covered by samples, s */
+    int64_t         offset_min;     /**< Minimum offset, ns */
+    int64_t         offset_max;     /**< Maximum offset, ns */
+    double          offset_mean;    /**< Mean offset, ns */
+    int64_t         abs_offset_p50; /**< Median of absolute offset, ns */
+    int64_t         abs_offset_p90; /**< 90th percentile of absolute
+                                         offset, ns */
+    int64_t         abs_offset_p99; /**< 99th percentile of absolute
+                                         offset, ns */
+    double          freq_min;       /**< Minimum frequency adjustment,
+                                         ppb */
+    double          freq_max;       /**< Maximum frequency adjustment,
+                                         ppb */
+    double          adev;           /**< Allan deviation at the sampling
+                                         interval, ppb */
+} libts_timestamps_clock_stats;
+
+/**
+ * Start sampling of the NIC clock offset from CLOCK_REALTIME and its
+ * frequency adjustment in background on the agent which controls
+ * TE_ORIG_IUT_TST1 interface. The last @p size samples are kept in
+ * a file on the agent, so they can be fetched by any test.
+ *
+ * @param interval  Interval between samples, ms.
+ * @param size      Number of samples to keep.
+ */
+extern void libts_timestamps_sampler_start(unsigned int interval,
+                                           unsigned int size);
+
+/**
+ * Get summary of the NIC clock samples collected by the background
+ * sampler so far.
+ *
+ * @param stats     Where to put the summary.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_timestamps_sampler_get_stats(
+                                libts_timestamps_clock_stats *stats);
+
+/**
+ * Log summary of the NIC clock samples.
+ *
+ * @param stats     Summary to log.
+ */
+extern void libts_timestamps_clock_stats_log(
+                            const libts_timestamps_clock_stats *stats);
+
+/**
+ * Stop the background NIC clock sampler if it is running.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_timestamps_sampler_stop(void);
+
+/**
+ * Parameters of one-way latency measurement using hardware timestamps.
+ */
+typedef struct libts_timestamps_latency_params {
+    unsigned int    n_packets;  /**< Number of packets to send */
+    size_t          size;       /**< Payload size, at least 4 bytes */
+    unsigned int    interval;   /**< Interval between packets, us */
+    unsigned int    timeout;    /**< Time to wait for a packet or its
+                                     timestamp, ms */
+} libts_timestamps_latency_params;
+
+/**
+ * Result of one-way latency measurement.
+ */
+typedef struct libts_timestamps_latency {
+    unsigned int    n_sent;     /**< Number of sent packets */
+    unsigned int    n_samples;  /**< Number of packets with both TX and
+                                     RX timestamps */
+    int64_t        *samples;    /**< Latencies in sending order, ns
+                                     (from the heap) */
+    int64_t         min;        /**< Minimum latency, ns */
+    int64_t         max;        /**< Maximum latency, ns */
+    double          mean;       /**< Mean latency, ns */
+    int64_t         p50;        /**< Median latency, ns */
+    int64_t         p99;        /**< 99th percentile, ns */
+    int64_t         p999;       /**< 99.9th percentile, ns */
+} libts_timestamps_latency;
+
+/**
+ * Measure one-way latency from IUT to Tester using hardware
+ * timestamps: UDP packets are sent from IUT and the TX hardware
+ * timestamp of every packet is paired with its RX hardware timestamp
+ * on Tester.
+ *
+ * @note NIC clocks on both sides must be synchronized, e.g. by sfptpd
+ *       (see libts_timestamps_enable_sfptpd()), and hardware timestamping
+ *       must be enabled on the interfaces.
+ *
+ * @param pco_iut       RPC server on IUT.
+ * @param pco_tst       RPC server on Tester.
+ * @param iut_addr      Address on IUT.
+ * @param tst_addr      Address on Tester.
+ * @param params        Measurement parameters.
+ * @param result        Where to put the result, should be released with
+ *                      libts_timestamps_latency_free().
+ */
+extern void libts_timestamps_measure_latency(
+                            rcf_rpc_server *pco_iut,
+                            rcf_rpc_server *pco_tst,
+                            const struct sockaddr *iut_addr,
+                            const struct sockaddr *tst_addr,
+                            const libts_timestamps_latency_params *params,
+                            libts_timestamps_latency *result);
+
+/**
+ * Log result of one-way latency measurement.
+ *
+ * @param result        Measurement result.
+ */
+extern void libts_timestamps_latency_log(
+                            const libts_timestamps_latency *result);
+
+/**
+ * Release resources allocated for one-way latency measurement result.
+ *
+ * @param result        Measurement result.
+ */
+extern void libts_timestamps_latency_free(libts_timestamps_latency *result);
+
 /**
  * Copy sfptpd to IUT agent and prepare configuration to start it.
  */
@@ -21,7 +218,14 @@ extern void libts_timestamps_configure_sfptpd(void);
 
 /**
  * Stop ntpd and start sfptpd on IUT TA (unless ST_RUN_TS_NO_SFPTPD
- * environment variable is set to @c 1).
+ * environment variable is set to @c 1) and wait until it synchronizes
+ * the NIC clock (see libts_timestamps_wait_sync()).
+ *
+ * @note If SFC_ONLOAD_PHC_SAMPLER environment variable is set to
+ *       @c TRUE, the background NIC clock sampler is started with
+ *       interval and size specified by SFC_ONLOAD_PHC_SAMPLER_INTERVAL
+ *       and SFC_ONLOAD_PHC_SAMPLER_SIZE environment variables (see
+ *       libts_timestamps_sampler_start()).
  *
  * @param pco_iut         RPC server on IUT.
  */
@@ -29,7 +233,8 @@ extern void libts_timestamps_enable_sfptpd(rcf_rpc_server *pco_iut);
 
 /**
  * Stop sfptpd on IUT if it was started previously by
- * libts_timestamps_enable_sfptpd().
+ * libts_timestamps_enable_sfptpd(). The background NIC clock sampler
+ * is stopped as well and summary of its samples is logged.
  *
  * @param pco_iut   RPC server on IUT.
  */
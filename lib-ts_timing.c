@@ -0,0 +1,307 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Steps timing API
+ *
+ * Implementation of setup steps timing.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Timing"
+
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "lib-ts.h"
+#include "lib-ts_timing.h"
+
+/** Timed step */
+typedef struct timing_step {
+    char           *name;       /**< Step name */
+    int             parent;     /**< Index of the parent step or @c -1 */
+    unsigned int    depth;      /**< Nesting depth */
+    double          start;      /**< Start time since the timeline base,
+                                     ms */
+    double          duration;   /**< Duration, ms, or negative value if
+                                     the step is not stopped yet */
+    te_bool         written;    /**< Whether the step is written to
+                                     the timeline file */
+} timing_step;
+
+/** Timeline of the process */
+static struct {
+    te_bool         checked;    /**< Whether the timing is checked to be
+                                     enabled */
+    const char     *path;       /**< Timeline file name or @c NULL if
+                                     timing is disabled */
+    double          base;       /**< Monotonic time of the first step, ms */
+    struct timespec base_real;  /**< Real time of the first step */
+    timing_step    *steps;      /**< Steps */
+    unsigned int    n_steps;    /**< Number of steps */
+    unsigned int    max_steps;  /**< Number of allocated steps */
+    unsigned int    n_pending;  /**< Number of stopped steps which are not
+                                     written to the file yet */
+} timeline;
+
+/** Lock protecting @p timeline */
+static pthread_mutex_t timeline_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Index of the current step of the thread */
+static __thread int timing_current = -1;
+
+/**
+ * Flush the timeline at the process exit.
+ */
+static void
+timing_atexit(void)
+{
+    libts_timing_flush();
+}
+
+/**
+ * Check whether timing is enabled and initialize the timeline on the
+ * first call. Should be called under @p timeline_lock.
+ *
+ * @return @c TRUE if timing is enabled.
+ */
+static te_bool
+timing_enabled(void)
+{
+    if (!timeline.checked)
+    {
+        timeline.checked = TRUE;
+        timeline.path = getenv("SFC_ONLOAD_TIMELINE");
+        if (timeline.path != NULL && timeline.path[0] == '\0')
+            timeline.path = NULL;
+
+        if (timeline.path != NULL)
+        {
+            timeline.base = libts_monotonic_ms();
+            clock_gettime(CLOCK_REALTIME, &timeline.base_real);
+            atexit(timing_atexit);
+        }
+    }
+
+    return timeline.path != NULL;
+}
+
+/* See description in lib-ts_timing.h */
+void
+libts_timing_start(const char *fmt, ...)
+{
+    te_string       name = TE_STRING_INIT;
+    timing_step    *step;
+    va_list         ap;
+
+    pthread_mutex_lock(&timeline_lock);
+    if (!timing_enabled())
+    {
+        pthread_mutex_unlock(&timeline_lock);
+        return;
+    }
+
+    if (timeline.n_steps == timeline.max_steps)
+    {
+        unsigned int    max = timeline.max_steps == 0 ? 32 :
+                                                      timeline.max_steps * 2;
+        timing_step    *steps = realloc(timeline.steps,
+                                        max * sizeof(*steps));
+
+        if (steps == NULL)
+        {
+            pthread_mutex_unlock(&timeline_lock);
+            WARN("Failed to allocate memory for step timing");
+            return;
+        }
+        timeline.steps = steps;
+        timeline.max_steps = max;
+    }
+
+    va_start(ap, fmt);
+    te_string_append_va(&name, fmt, ap);
+    va_end(ap);
+
+    step = &timeline.steps[timeline.n_steps];
+    step->name = name.ptr;
+    step->parent = timing_current;
+    step->depth = timing_current < 0 ? 0 :
+                  timeline.steps[timing_current].depth + 1;
+    step->start = libts_monotonic_ms() - timeline.base;
+    step->duration = -1;
+    step->written = FALSE;
+    timing_current = timeline.n_steps++;
+
+    pthread_mutex_unlock(&timeline_lock);
+}
+
+/* See description in lib-ts_timing.h */
+void
+libts_timing_stop(void)
+{
+    timing_step    *step;
+    char           *name;
+    double          duration;
+
+    if (timing_current < 0)
+        return;
+
+    pthread_mutex_lock(&timeline_lock);
+    step = &timeline.steps[timing_current];
+    step->duration = libts_monotonic_ms() - timeline.base - step->start;
+    timing_current = step->parent;
+    timeline.n_pending++;
+    name = step->name == NULL ? NULL : strdup(step->name);
+    duration = step->duration;
+    pthread_mutex_unlock(&timeline_lock);
+
+    RING("Step '%s' took %.3f ms", name == NULL ? "" : name, duration);
+    free(name);
+}
+
+/* See description in lib-ts_timing.h */
+unsigned int
+libts_timing_depth(void)
+{
+    unsigned int depth;
+
+    if (timing_current < 0)
+        return 0;
+
+    pthread_mutex_lock(&timeline_lock);
+    depth = timeline.steps[timing_current].depth + 1;
+    pthread_mutex_unlock(&timeline_lock);
+
+    return depth;
+}
+
+/* See description in lib-ts_timing.h */
+void
+libts_timing_stop_to(unsigned int depth)
+{
+    while (libts_timing_depth() > depth)
+        libts_timing_stop();
+}
+
+/**
+ * Append a string to a file escaping it as JSON string.
+ *
+ * @param f         File.
+ * @param str       String.
+ */
+static void
+json_write_str(FILE *f, const char *str)
+{
+    fputc('"', f);
+    for (; str != NULL && *str != '\0'; str++)
+    {
+        if (*str == '"' || *str == '\\')
+            fputc('\\', f);
+        if ((unsigned char)*str < ' ')
+            fprintf(f, "\\u%04x", *str);
+        else
+            fputc(*str, f);
+    }
+    fputc('"', f);
+}
+
+/**
+ * Write full name of a step (names of all parents separated by '/') to
+ * a file.
+ *
+ * @param f         File.
+ * @param idx       Step index.
+ */
+static void
+csv_write_name(FILE *f, int idx)
+{
+    if (timeline.steps[idx].parent >= 0)
+    {
+        csv_write_name(f, timeline.steps[idx].parent);
+        fputc('/', f);
+    }
+    fputs(timeline.steps[idx].name == NULL ? "" : timeline.steps[idx].name,
+          f);
+}
+
+/* See description in lib-ts_timing.h */
+te_errno
+libts_timing_flush(void)
+{
+    te_bool         csv;
+    te_bool         first = TRUE;
+    unsigned int    i;
+    FILE           *f;
+    te_errno        rc = 0;
+
+    pthread_mutex_lock(&timeline_lock);
+    if (!timing_enabled() || timeline.n_pending == 0)
+    {
+        pthread_mutex_unlock(&timeline_lock);
+        return 0;
+    }
+
+    f = fopen(timeline.path, "a");
+    if (f == NULL)
+    {
+        rc = TE_RC(TE_TAPI, te_rc_os2te(errno));
+        pthread_mutex_unlock(&timeline_lock);
+        ERROR("Failed to open timeline file '%s': %r", timeline.path, rc);
+        return rc;
+    }
+
+    csv = strlen(timeline.path) > 4 &&
+          strcmp(timeline.path + strlen(timeline.path) - 4, ".csv") == 0;
+
+    if (csv)
+    {
+        if (ftell(f) == 0)
+            fprintf(f, "pid,base,step,depth,start_ms,duration_ms\n");
+    }
+    else
+    {
+        fprintf(f, "{\"pid\":%d,\"base\":%lld.%06ld,\"steps\":[",
+                (int)getpid(), (long long)timeline.base_real.tv_sec,
+                timeline.base_real.tv_nsec / 1000);
+    }
+
+    /* Steps which are still running are written later */
+    for (i = 0; i < timeline.n_steps; i++)
+    {
+        timing_step *step = &timeline.steps[i];
+
+        if (step->duration < 0 || step->written)
+            continue;
+
+        if (csv)
+        {
+            fprintf(f, "%d,%lld.%06ld,", (int)getpid(),
+                    (long long)timeline.base_real.tv_sec,
+                    timeline.base_real.tv_nsec / 1000);
+            csv_write_name(f, i);
+            fprintf(f, ",%u,%.3f,%.3f\n", step->depth, step->start,
+                    step->duration);
+        }
+        else
+        {
+            fprintf(f, "%s{\"id\":%u,\"name\":", first ? "" : ",", i);
+            json_write_str(f, step->name);
+            fprintf(f, ",\"parent\":%d,\"depth\":%u,\"start_ms\":%.3f,"
+                    "\"duration_ms\":%.3f}", step->parent, step->depth,
+                    step->start, step->duration);
+        }
+        step->written = TRUE;
+        first = FALSE;
+    }
+    timeline.n_pending = 0;
+
+    if (!csv)
+        fprintf(f, "]}\n");
+
+    if (fclose(f) != 0)
+        rc = TE_RC(TE_TAPI, te_rc_os2te(errno));
+
+    pthread_mutex_unlock(&timeline_lock);
+    return rc;
+}
@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Steps timing API
+ *
+ * Instrumentation to measure duration of setup steps (e.g. in prologue)
+ * and save the timeline of a run in machine-readable form.
+ *
+ * Timing is enabled by SFC_ONLOAD_TIMELINE environment variable which
+ * specifies the file to append the timeline of every test process to.
+ * If the file name ends with ".csv", a CSV row is written per step,
+ * otherwise a JSON object per process is written on a separate line.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_TIMING_H__
+#define __ONLOAD_LIB_TS_TIMING_H__
+
+#include "te_errno.h"
+
+/**
+ * Start timing of a step. Steps started before the current step of
+ * the calling thread is stopped are nested into it.
+ *
+ * @param fmt       Format string of the step name.
+ * @param ...       Format string arguments.
+ */
+extern void libts_timing_start(const char *fmt, ...)
+                               __attribute__((format(printf, 1, 2)));
+
+/**
+ * Stop timing of the current step of the calling thread.
+ */
+extern void libts_timing_stop(void);
+
+/**
+ * Get nesting depth of the current step of the calling thread, i.e.
+ * the number of its steps which are started and not stopped yet.
+ *
+ * @return Nesting depth.
+ */
+extern unsigned int libts_timing_depth(void);
+
+/**
+ * Stop timing of steps of the calling thread until the nesting depth
+ * obtained with libts_timing_depth() is reached, e.g. to close steps
+ * left open by a function which failed with a jump.
+ *
+ * @param depth     Nesting depth to return to.
+ */
+extern void libts_timing_stop_to(unsigned int depth);
+
+/**
+ * Append steps stopped so far to the timeline file. It is done
+ * automatically at the process exit.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_timing_flush(void);
+
+#endif /* !__ONLOAD_LIB_TS_TIMING_H__ */
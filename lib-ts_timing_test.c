@@ -0,0 +1,177 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Steps timing API unit test
+ *
+ * Checks of steps nesting and of the timeline written in JSON and CSV
+ * forms. The monotonic clock is faked, so durations are exact.
+ *
+ * @author agent <agent@local>
+ */
+
+#include "lib-ts_timing.c"
+#include "lib-ts_unit.h"
+
+DEFINE_LGR_ENTITY("libts_timing_test");
+
+/** Fake monotonic time, ms */
+static double fake_now = 1000;
+
+/* Fake of the function from lib-ts.c */
+double
+libts_monotonic_ms(void)
+{
+    return fake_now;
+}
+
+/**
+ * Read a file and remove it.
+ *
+ * @param path      File name.
+ * @param buf       Where to put the contents.
+ * @param size      Size of @p buf.
+ */
+static void
+read_file(const char *path, char *buf, size_t size)
+{
+    FILE   *f = fopen(path, "r");
+    size_t  len = 0;
+
+    if (f != NULL)
+    {
+        len = fread(buf, 1, size - 1, f);
+        fclose(f);
+    }
+    buf[len] = '\0';
+    unlink(path);
+}
+
+/**
+ * Make the timeline be checked again with a new file name.
+ *
+ * @param path      Timeline file name.
+ */
+static void
+timeline_restart(const char *path)
+{
+    setenv("SFC_ONLOAD_TIMELINE", path, 1);
+    timeline.checked = FALSE;
+}
+
+/**
+ * Check nesting depth of steps.
+ */
+static void
+test_depth(void)
+{
+    char path[] = "/tmp/libts_timing_test_XXXXXX";
+    int  fd = mkstemp(path);
+
+    LIBTS_UNIT_CHECK(fd >= 0);
+    close(fd);
+    timeline_restart(path);
+
+    LIBTS_UNIT_CHECK(libts_timing_depth() == 0);
+    libts_timing_start("a");
+    libts_timing_start("b");
+    libts_timing_start("c");
+    LIBTS_UNIT_CHECK(libts_timing_depth() == 3);
+    libts_timing_stop();
+    LIBTS_UNIT_CHECK(libts_timing_depth() == 2);
+    libts_timing_stop_to(0);
+    LIBTS_UNIT_CHECK(libts_timing_depth() == 0);
+    libts_timing_stop();
+    LIBTS_UNIT_CHECK(libts_timing_depth() == 0);
+
+    LIBTS_UNIT_CHECK(libts_timing_flush() == 0);
+    unlink(path);
+}
+
+/**
+ * Check the timeline in JSON form: only stopped steps are written and
+ * they are written once.
+ */
+static void
+test_json(void)
+{
+    char path[] = "/tmp/libts_timing_test_XXXXXX";
+    char buf[4096];
+    int  fd = mkstemp(path);
+
+    LIBTS_UNIT_CHECK(fd >= 0);
+    close(fd);
+    timeline_restart(path);
+
+    libts_timing_start("setup");
+    fake_now += 10;
+    libts_timing_start("copy \"%s\"", "lib");
+    fake_now += 2.5;
+    libts_timing_stop();
+
+    LIBTS_UNIT_CHECK(libts_timing_flush() == 0);
+    read_file(path, buf, sizeof(buf));
+    LIBTS_UNIT_CHECK(strstr(buf, "\"steps\":[{") != NULL);
+    LIBTS_UNIT_CHECK(strstr(buf, "\"name\":\"copy \\\"lib\\\"\","
+                                 "\"parent\":") != NULL);
+    LIBTS_UNIT_CHECK(strstr(buf, "\"depth\":1,") != NULL);
+    LIBTS_UNIT_CHECK(strstr(buf, "\"duration_ms\":2.500}") != NULL);
+    LIBTS_UNIT_CHECK(strstr(buf, "\"setup\"") == NULL);
+
+    fake_now += 1;
+    libts_timing_stop();
+    LIBTS_UNIT_CHECK(libts_timing_flush() == 0);
+    read_file(path, buf, sizeof(buf));
+    LIBTS_UNIT_CHECK(strstr(buf, "\"name\":\"setup\",\"parent\":-1,"
+                                 "\"depth\":0,") != NULL);
+    LIBTS_UNIT_CHECK(strstr(buf, "\"duration_ms\":13.500}]}\n") != NULL);
+    LIBTS_UNIT_CHECK(strstr(buf, "copy") == NULL);
+
+    LIBTS_UNIT_CHECK(libts_timing_flush() == 0);
+    read_file(path, buf, sizeof(buf));
+    LIBTS_UNIT_CHECK(buf[0] == '\0');
+}
+
+/**
+ * Check the timeline in CSV form: the header is written to an empty
+ * file only and steps have full names.
+ */
+static void
+test_csv(void)
+{
+    char path[] = "/tmp/libts_timing_test_XXXXXX.csv";
+    char buf[4096];
+    int  fd = mkstemps(path, 4);
+
+    LIBTS_UNIT_CHECK(fd >= 0);
+    close(fd);
+    timeline_restart(path);
+
+    libts_timing_start("prologue");
+    libts_timing_start("netns");
+    fake_now += 4;
+    libts_timing_stop_to(0);
+
+    LIBTS_UNIT_CHECK(libts_timing_flush() == 0);
+    libts_timing_start("epilogue");
+    libts_timing_stop();
+    LIBTS_UNIT_CHECK(libts_timing_flush() == 0);
+
+    read_file(path, buf, sizeof(buf));
+    LIBTS_UNIT_CHECK(strncmp(buf, "pid,base,step,depth,start_ms,"
+                                  "duration_ms\n", 41) == 0);
+    LIBTS_UNIT_CHECK(strstr(buf + 1, "pid,") == NULL);
+    LIBTS_UNIT_CHECK(strstr(buf, ",prologue/netns,1,") != NULL);
+    LIBTS_UNIT_CHECK(strstr(buf, ",4.000\n") != NULL);
+    LIBTS_UNIT_CHECK(strstr(buf, ",prologue,0,") != NULL);
+    LIBTS_UNIT_CHECK(strstr(buf, ",epilogue,0,") != NULL);
+}
+
+int
+main(void)
+{
+    test_depth();
+    test_json();
+    test_csv();
+
+    return libts_unit_result();
+}
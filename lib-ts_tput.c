@@ -0,0 +1,304 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Throughput measurement API
+ *
+ * Implementation of multi-stream throughput measurement.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Tput"
+
+#include "lib-ts.h"
+#include "lib-ts_tput.h"
+#include "tapi_rpc_socket.h"
+#include "tapi_rpc_unistd.h"
+#include "tapi_rpc_misc.h"
+#include "tapi_rpc_client_server.h"
+#include "tapi_rpcsock_macros.h"
+
+/**
+ * Time receivers run after senders are stopped to get data left in
+ * buffers, s.
+ */
+#define TPUT_RECV_SLACK 2
+
+/** Additional time to wait for a sending or receiving loop, s */
+#define TPUT_RPC_SLACK 10
+
+/** Stream of the measurement */
+typedef struct tput_conn {
+    int             iut_s;      /**< Socket on IUT */
+    int             tst_s;      /**< Socket on Tester */
+    rcf_rpc_server *tx;         /**< Thread RPC server of the sender */
+    rcf_rpc_server *rx;         /**< Thread RPC server of the receiver */
+    int             tx_s;       /**< Sending socket */
+    int             rx_s;       /**< Receiving socket */
+} tput_conn;
+
+/** CPU times of a host */
+typedef struct tput_cpu {
+    unsigned long long  busy;   /**< Non-idle time, ticks */
+    unsigned long long  total;  /**< Total time, ticks */
+} tput_cpu;
+
+/**
+ * Get CPU times of all CPUs of an agent host from /proc/stat.
+ *
+ * @param ta        Test agent.
+ * @param cpu       Where to put CPU times.
+ *
+ * @return Status code.
+ */
+static te_errno
+tput_cpu_get(const char *ta, tput_cpu *cpu)
+{
+    unsigned long long  t[8] = { 0, };
+    char               *out = NULL;
+    unsigned int        i;
+    te_errno            rc;
+
+    rc = libts_ta_shell_get(ta, &out, "head -n 1 /proc/stat");
+    if (rc != 0)
+        return rc;
+
+    /* user nice system idle iowait irq softirq steal */
+    if (sscanf(out, "cpu %llu %llu %llu %llu %llu %llu %llu %llu",
+               &t[0], &t[1], &t[2], &t[3], &t[4], &t[5], &t[6],
+               &t[7]) < 4)
+    {
+        ERROR("Unexpected /proc/stat format on %s: %s", ta, out);
+        free(out);
+        return TE_RC(TE_TAPI, TE_EINVAL);
+    }
+    free(out);
+
+    cpu->total = 0;
+    for (i = 0; i < TE_ARRAY_LEN(t); i++)
+        cpu->total += t[i];
+    cpu->busy = cpu->total - t[3] - t[4];
+
+    return 0;
+}
+
+/**
+ * Get CPU use between two samples.
+ *
+ * @param before    The earlier sample.
+ * @param after     The later sample.
+ *
+ * @return CPU use, % of all CPUs.
+ */
+static double
+tput_cpu_use(const tput_cpu *before, const tput_cpu *after)
+{
+    if (after->total <= before->total)
+        return 0;
+
+    return 100. * (after->busy - before->busy) /
+           (after->total - before->total);
+}
+
+/**
+ * Establish connection of a stream and create thread RPC servers for
+ * its sending and receiving loops.
+ *
+ * @param pco_iut       RPC server on IUT.
+ * @param pco_tst       RPC server on Tester.
+ * @param iut_addr      Address on IUT.
+ * @param tst_addr      Address on Tester.
+ * @param params        Measurement parameters.
+ * @param idx           Stream index.
+ * @param conn          Stream to initialize.
+ */
+static void
+tput_conn_open(rcf_rpc_server *pco_iut, rcf_rpc_server *pco_tst,
+               const struct sockaddr *iut_addr,
+               const struct sockaddr *tst_addr,
+               const libts_tput_params *params, unsigned int idx,
+               tput_conn *conn)
+{
+    struct sockaddr_storage iut_a;
+    struct sockaddr_storage tst_a;
+    rcf_rpc_server         *tx_base;
+    rcf_rpc_server         *rx_base;
+    char                    name[RCF_MAX_NAME];
+
+    tapi_sockaddr_clone_exact(iut_addr, &iut_a);
+    tapi_sockaddr_clone_exact(tst_addr, &tst_a);
+    CHECK_RC(tapi_allocate_set_port(pco_iut, SA(&iut_a)));
+    CHECK_RC(tapi_allocate_set_port(pco_tst, SA(&tst_a)));
+
+    GEN_CONNECTION(pco_tst, pco_iut, params->sock_type, RPC_PROTO_DEF,
+                   SA(&tst_a), SA(&iut_a), &conn->tst_s, &conn->iut_s);
+
+    tx_base = params->iut_sends ? pco_iut : pco_tst;
+    rx_base = params->iut_sends ? pco_tst : pco_iut;
+    conn->tx_s = params->iut_sends ? conn->iut_s : conn->tst_s;
+    conn->rx_s = params->iut_sends ? conn->tst_s : conn->iut_s;
+
+    snprintf(name, sizeof(name), "%s_tput_tx%u", tx_base->name, idx);
+    CHECK_RC(rcf_rpc_server_thread_create(tx_base, name, &conn->tx));
+    snprintf(name, sizeof(name), "%s_tput_rx%u", rx_base->name, idx);
+    CHECK_RC(rcf_rpc_server_thread_create(rx_base, name, &conn->rx));
+}
+
+/* See description in lib-ts_tput.h */
+void
+libts_tput_params_init(libts_tput_params *params)
+{
+    memset(params, 0, sizeof(*params));
+    params->sock_type = RPC_SOCK_STREAM;
+    params->n_streams = LIBTS_TPUT_STREAMS_DEF;
+    params->size_min = LIBTS_TPUT_SIZE_DEF;
+    params->size_max = LIBTS_TPUT_SIZE_DEF;
+    params->duration = LIBTS_TPUT_DURATION_DEF;
+    params->iut_sends = TRUE;
+}
+
+/* See description in lib-ts_tput.h */
+void
+libts_tput_measure(rcf_rpc_server *pco_iut, rcf_rpc_server *pco_tst,
+                   const struct sockaddr *iut_addr,
+                   const struct sockaddr *tst_addr,
+                   const libts_tput_params *params,
+                   libts_tput_result *result)
+{
+    unsigned int    n = params->n_streams;
+    unsigned int    recv_time = params->duration + TPUT_RECV_SLACK;
+    tput_conn      *conns;
+    tput_conn      *c;
+    tput_cpu        iut_before;
+    tput_cpu        iut_after;
+    tput_cpu        tst_before;
+    tput_cpu        tst_after;
+    uint64_t        dummy;
+    unsigned int    i;
+
+    memset(result, 0, sizeof(*result));
+
+    if (n == 0 || params->duration == 0 ||
+        params->size_min == 0 || params->size_min > params->size_max ||
+        params->delay_min > params->delay_max)
+        TEST_FAIL("Invalid throughput measurement parameters");
+
+    conns = calloc(n, sizeof(*conns));
+    result->streams = calloc(n, sizeof(*result->streams));
+    if (conns == NULL || result->streams == NULL)
+        TEST_FAIL("Memory allocation failure");
+    result->n_streams = n;
+
+    for (i = 0; i < n; i++)
+    {
+        conns[i].iut_s = -1;
+        conns[i].tst_s = -1;
+        tput_conn_open(pco_iut, pco_tst, iut_addr, tst_addr, params, i,
+                       &conns[i]);
+    }
+
+    CHECK_RC(tput_cpu_get(pco_iut->ta, &iut_before));
+    CHECK_RC(tput_cpu_get(pco_tst->ta, &tst_before));
+
+    /* Receivers are started first to not lose the first messages */
+    for (i = 0; i < n; i++)
+    {
+        c = &conns[i];
+        c->rx->op = RCF_RPC_CALL;
+        rpc_simple_receiver(c->rx, c->rx_s, recv_time, &dummy);
+    }
+    for (i = 0; i < n; i++)
+    {
+        c = &conns[i];
+        c->tx->op = RCF_RPC_CALL;
+        rpc_simple_sender(c->tx, c->tx_s, params->size_min,
+                          params->size_max, FALSE, params->delay_min,
+                          params->delay_max, FALSE, params->duration,
+                          &dummy, FALSE);
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        c = &conns[i];
+        c->tx->timeout = (params->duration + TPUT_RPC_SLACK) * 1000;
+        c->tx->op = RCF_RPC_WAIT;
+        rpc_simple_sender(c->tx, c->tx_s, params->size_min,
+                          params->size_max, FALSE, params->delay_min,
+                          params->delay_max, FALSE, params->duration,
+                          &result->streams[i].sent, FALSE);
+    }
+
+    /* Receivers just drain buffers after this moment */
+    CHECK_RC(tput_cpu_get(pco_iut->ta, &iut_after));
+    CHECK_RC(tput_cpu_get(pco_tst->ta, &tst_after));
+
+    for (i = 0; i < n; i++)
+    {
+        c = &conns[i];
+        c->rx->timeout = (recv_time + TPUT_RPC_SLACK) * 1000;
+        c->rx->op = RCF_RPC_WAIT;
+        rpc_simple_receiver(c->rx, c->rx_s, recv_time,
+                            &result->streams[i].received);
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        c = &conns[i];
+        CHECK_RC(rcf_rpc_server_destroy(c->tx));
+        CHECK_RC(rcf_rpc_server_destroy(c->rx));
+        RPC_CLOSE(pco_iut, c->iut_s);
+        RPC_CLOSE(pco_tst, c->tst_s);
+
+        result->streams[i].goodput = result->streams[i].received * 8. /
+                                     params->duration / 1e6;
+        result->sent += result->streams[i].sent;
+        result->received += result->streams[i].received;
+    }
+    free(conns);
+
+    result->goodput = result->received * 8. / params->duration / 1e6;
+    result->cpu_iut = tput_cpu_use(&iut_before, &iut_after);
+    result->cpu_tst = tput_cpu_use(&tst_before, &tst_after);
+}
+
+/* See description in lib-ts_tput.h */
+void
+libts_tput_result_log(const libts_tput_result *result)
+{
+    te_string       str = TE_STRING_INIT;
+    unsigned int    i;
+    te_errno        rc = 0;
+
+    for (i = 0; i < result->n_streams && rc == 0; i++)
+    {
+        rc = te_string_append(&str, "stream %u: sent %llu, received %llu "
+                              "bytes, goodput %.1f Mbit/s\n", i,
+                              (unsigned long long)result->streams[i].sent,
+                              (unsigned long long)
+                                  result->streams[i].received,
+                              result->streams[i].goodput);
+    }
+    if (rc != 0)
+    {
+        ERROR("Failed to format throughput measurement result");
+        te_string_free(&str);
+        return;
+    }
+
+    RING("Throughput of %u streams: sent %llu, received %llu bytes, "
+         "goodput %.1f Mbit/s, CPU use IUT %.1f%%, Tester %.1f%%\n%s",
+         result->n_streams, (unsigned long long)result->sent,
+         (unsigned long long)result->received, result->goodput,
+         result->cpu_iut, result->cpu_tst, str.len == 0 ? "" : str.ptr);
+
+    te_string_free(&str);
+}
+
+/* See description in lib-ts_tput.h */
+void
+libts_tput_result_free(libts_tput_result *result)
+{
+    free(result->streams);
+    result->streams = NULL;
+    result->n_streams = 0;
+}
@@ -0,0 +1,114 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Throughput measurement API
+ *
+ * Multi-stream throughput measurement between IUT and Tester. Every
+ * stream is a connection with its own pair of thread RPC servers
+ * running sending and receiving loops on the agents concurrently, so
+ * the engine only starts the loops and collects the results.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_TPUT_H__
+#define __ONLOAD_LIB_TS_TPUT_H__
+
+#include "te_errno.h"
+#include "lib-ts.h"
+#include "tapi_rpc_socket.h"
+
+/** Default number of streams */
+#define LIBTS_TPUT_STREAMS_DEF 1
+/** Default message size, bytes */
+#define LIBTS_TPUT_SIZE_DEF 1400
+/** Default measurement duration, s */
+#define LIBTS_TPUT_DURATION_DEF 10
+
+/**
+ * Parameters of throughput measurement.
+ */
+typedef struct libts_tput_params {
+    rpc_socket_type sock_type;  /**< Socket type */
+    unsigned int    n_streams;  /**< Number of streams */
+    unsigned int    size_min;   /**< Minimum message size, bytes */
+    unsigned int    size_max;   /**< Maximum message size, bytes */
+    unsigned int    delay_min;  /**< Minimum delay between messages
+                                     (pacing), us */
+    unsigned int    delay_max;  /**< Maximum delay between messages,
+                                     us */
+    unsigned int    duration;   /**< Sending time, s */
+    te_bool         iut_sends;  /**< Whether IUT sends (otherwise
+                                     Tester sends) */
+} libts_tput_params;
+
+/**
+ * Result of a stream.
+ */
+typedef struct libts_tput_stream {
+    uint64_t    sent;       /**< Sent bytes */
+    uint64_t    received;   /**< Received bytes */
+    double      goodput;    /**< Goodput, Mbit/s */
+} libts_tput_stream;
+
+/**
+ * Result of throughput measurement.
+ */
+typedef struct libts_tput_result {
+    unsigned int        n_streams;  /**< Number of streams */
+    libts_tput_stream  *streams;    /**< Results of streams (from the
+                                         heap) */
+    uint64_t            sent;       /**< Sent bytes of all streams */
+    uint64_t            received;   /**< Received bytes of all streams */
+    double              goodput;    /**< Aggregate goodput, Mbit/s */
+    double              cpu_iut;    /**< CPU use on IUT host, % of all
+                                         CPUs */
+    double              cpu_tst;    /**< CPU use on Tester host, % of all
+                                         CPUs */
+} libts_tput_result;
+
+/**
+ * Initialize throughput measurement parameters with defaults: one TCP
+ * stream from IUT sending messages of @c LIBTS_TPUT_SIZE_DEF bytes
+ * without delays for @c LIBTS_TPUT_DURATION_DEF seconds.
+ *
+ * @param params    Parameters to initialize.
+ */
+extern void libts_tput_params_init(libts_tput_params *params);
+
+/**
+ * Measure throughput between IUT and Tester, e.g. between the namespace
+ * agent created by libts_setup_namespace() and Tester. Connections are
+ * established between the given addresses with free ports. Test fails
+ * on errors.
+ *
+ * @param pco_iut       RPC server on IUT.
+ * @param pco_tst       RPC server on Tester.
+ * @param iut_addr      Address on IUT.
+ * @param tst_addr      Address on Tester.
+ * @param params        Measurement parameters.
+ * @param result        Where to put the result, should be released with
+ *                      libts_tput_result_free().
+ */
+extern void libts_tput_measure(rcf_rpc_server *pco_iut,
+                               rcf_rpc_server *pco_tst,
+                               const struct sockaddr *iut_addr,
+                               const struct sockaddr *tst_addr,
+                               const libts_tput_params *params,
+                               libts_tput_result *result);
+
+/**
+ * Log result of throughput measurement.
+ *
+ * @param result        Result to log.
+ */
+extern void libts_tput_result_log(const libts_tput_result *result);
+
+/**
+ * Release result of throughput measurement.
+ *
+ * @param result        Result to release.
+ */
+extern void libts_tput_result_free(libts_tput_result *result);
+
+#endif /* !__ONLOAD_LIB_TS_TPUT_H__ */
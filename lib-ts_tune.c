@@ -0,0 +1,444 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Onload/ZF tuning API
+ *
+ * Implementation of Onload/ZF tuning functions.
+ *
+ * @author agent <agent@local>
+ */
+
+#define TE_LGR_USER     "Libts Tune"
+
+#include "lib-ts.h"
+#include "lib-ts_tune.h"
+
+/** Low-latency spinning profile */
+static const libts_tune_setting tune_latency[] = {
+    { LIBTS_TUNE_ENV, "EF_POLL_USEC", "100000" },
+    { LIBTS_TUNE_ENV, "EF_INT_DRIVEN", "0" },
+    { LIBTS_TUNE_ENV, "EF_TCP_FASTSTART_INIT", "0" },
+    { LIBTS_TUNE_ENV, "EF_TCP_FASTSTART_IDLE", "0" },
+};
+
+/** Throughput profile */
+static const libts_tune_setting tune_throughput[] = {
+    { LIBTS_TUNE_ENV, "EF_POLL_USEC", NULL },
+    { LIBTS_TUNE_ENV, "EF_RXQ_SIZE", "4096" },
+    { LIBTS_TUNE_ENV, "EF_TXQ_SIZE", "2048" },
+    { LIBTS_TUNE_ENV, "EF_MAX_PACKETS", "131072" },
+    { LIBTS_TUNE_ZF_ATTR, "rx_ring_max", "4096" },
+    { LIBTS_TUNE_ZF_ATTR, "tx_ring_max", "2048" },
+};
+
+/** Low memory profile */
+static const libts_tune_setting tune_low_memory[] = {
+    { LIBTS_TUNE_ENV, "EF_RXQ_SIZE", "512" },
+    { LIBTS_TUNE_ENV, "EF_TXQ_SIZE", "512" },
+    { LIBTS_TUNE_ENV, "EF_MAX_PACKETS", "8192" },
+    { LIBTS_TUNE_ZF_ATTR, "rx_ring_max", "512" },
+    { LIBTS_TUNE_ZF_ATTR, "tx_ring_max", "512" },
+    { LIBTS_TUNE_ZF_ATTR, "n_bufs", "4096" },
+};
+
+/** Predefined profiles */
+static const libts_tune_profile tune_profiles[] = {
+    { "latency", "Low-latency spinning",
+      tune_latency, TE_ARRAY_LEN(tune_latency) },
+    { "throughput", "Large queues and packet buffers pool",
+      tune_throughput, TE_ARRAY_LEN(tune_throughput) },
+    { "low_memory", "Small queues and packet buffers pool",
+      tune_low_memory, TE_ARRAY_LEN(tune_low_memory) },
+};
+
+/**
+ * Get value of an environment variable of an agent.
+ *
+ * @param ta        Agent name.
+ * @param name      Variable name.
+ * @param value     Where to put the value (from the heap).
+ *
+ * @return Status code (@c TE_ENOENT if the variable is not set).
+ */
+static te_errno
+env_get(const char *ta, const char *name, char **value)
+{
+    cfg_val_type val_type = CVT_STRING;
+
+    return cfg_get_instance_fmt(&val_type, value, "/local:%s/env:%s",
+                                ta, name);
+}
+
+/**
+ * Set or unset an environment variable in a configurator subtree.
+ *
+ * @param subtree   Subtree: "local" or "agent".
+ * @param ta        Agent name.
+ * @param name      Variable name.
+ * @param value     Value or @c NULL to unset.
+ *
+ * @return Status code.
+ */
+static te_errno
+env_set_subtree(const char *subtree, const char *ta, const char *name,
+                const char *value)
+{
+    cfg_handle  handle;
+    te_errno    rc;
+
+    rc = cfg_find_fmt(&handle, "/%s:%s/env:%s", subtree, ta, name);
+    if (rc != 0 && TE_RC_GET_ERROR(rc) != TE_ENOENT)
+        return rc;
+
+    if (value == NULL)
+    {
+        if (rc != 0)
+            return 0;
+        return cfg_del_instance(handle, FALSE);
+    }
+
+    if (rc == 0)
+        return cfg_set_instance(handle, CVT_STRING, value);
+
+    return cfg_add_instance_fmt(NULL, CVT_STRING, value, "/%s:%s/env:%s",
+                                subtree, ta, name);
+}
+
+/**
+ * Set or unset an environment variable of an agent.
+ *
+ * /local:<agent>/env: is copied to /agent:<agent>/env: only by
+ * tapi_cfg_env_local_to_agent() in the prologue, so the variable is
+ * changed in both subtrees for the change to reach processes which are
+ * started by the agent later.
+ *
+ * @param ta        Agent name.
+ * @param name      Variable name.
+ * @param value     Value or @c NULL to unset.
+ *
+ * @return Status code.
+ */
+static te_errno
+env_set(const char *ta, const char *name, const char *value)
+{
+    te_errno rc;
+
+    rc = env_set_subtree("local", ta, name, value);
+    if (rc == 0)
+        rc = env_set_subtree("agent", ta, name, value);
+
+    return rc;
+}
+
+/**
+ * Check whether an item of ZF attributes list has the key.
+ *
+ * @param item      Item ("key=value" or "key").
+ * @param item_len  Length of the item.
+ * @param key       Key.
+ *
+ * @return @c TRUE if the item has the key.
+ */
+static te_bool
+zf_attr_match(const char *item, size_t item_len, const char *key)
+{
+    size_t key_len = strlen(key);
+
+    return item_len >= key_len && strncmp(item, key, key_len) == 0 &&
+           (item_len == key_len || item[key_len] == '=');
+}
+
+/**
+ * Find a key in ZF attributes list.
+ *
+ * @param attrs     Attributes list.
+ * @param key       Key.
+ * @param len       Where to put length of the found item.
+ *
+ * @return Offset of the found item or @c -1.
+ */
+static ssize_t
+zf_attr_find(const char *attrs, const char *key, size_t *len)
+{
+    size_t pos = 0;
+    size_t item_len;
+
+    while (attrs[pos] != '\0')
+    {
+        item_len = strcspn(attrs + pos, ";");
+        if (zf_attr_match(attrs + pos, item_len, key))
+        {
+            *len = item_len;
+            return pos;
+        }
+
+        pos += item_len;
+        if (attrs[pos] == ';')
+            pos++;
+    }
+
+    return -1;
+}
+
+/**
+ * Replace or remove all items of a key in ZF attributes list.
+ *
+ * @param attrs     Attributes list.
+ * @param key       Key.
+ * @param value     Value or @c NULL to remove the key.
+ * @param result    Where to append the updated list.
+ *
+ * @return Status code.
+ */
+static te_errno
+zf_attr_edit(const char *attrs, const char *key, const char *value,
+             te_string *result)
+{
+    te_bool     done = FALSE;
+    size_t      pos = 0;
+    size_t      item_len;
+    te_errno    rc = 0;
+
+    while (attrs[pos] != '\0' && rc == 0)
+    {
+        item_len = strcspn(attrs + pos, ";");
+        if (item_len > 0)
+        {
+            if (zf_attr_match(attrs + pos, item_len, key))
+            {
+                /* The key is replaced in place, duplicates are dropped */
+                if (value != NULL && !done)
+                {
+                    rc = te_string_append(result, "%s%s=%s",
+                                          result->len == 0 ? "" : ";",
+                                          key, value);
+                }
+                done = TRUE;
+            }
+            else
+            {
+                rc = te_string_append(result, "%s%.*s",
+                                      result->len == 0 ? "" : ";",
+                                      (int)item_len, attrs + pos);
+            }
+        }
+
+        pos += item_len;
+        if (attrs[pos] == ';')
+            pos++;
+    }
+
+    if (rc == 0 && value != NULL && !done)
+    {
+        rc = te_string_append(result, "%s%s=%s",
+                              result->len == 0 ? "" : ";", key, value);
+    }
+
+    return rc;
+}
+
+/* See description in lib-ts_tune.h */
+te_errno
+libts_tune_get(const char *ta, libts_tune_kind kind, const char *name,
+               char **value)
+{
+    char       *attrs = NULL;
+    ssize_t     pos;
+    size_t      len;
+    size_t      name_len = strlen(name);
+    te_errno    rc;
+
+    if (kind == LIBTS_TUNE_ENV)
+    {
+        rc = env_get(ta, name, value);
+        if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
+            rc = TE_RC(TE_TAPI, TE_ENOENT);
+        return rc;
+    }
+
+    rc = env_get(ta, LIBTS_TUNE_ZF_ATTR_VAR, &attrs);
+    if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
+        return TE_RC(TE_TAPI, TE_ENOENT);
+    else if (rc != 0)
+        return rc;
+
+    pos = zf_attr_find(attrs, name, &len);
+    if (pos < 0)
+    {
+        rc = TE_RC(TE_TAPI, TE_ENOENT);
+    }
+    else
+    {
+        /* A key without '=' has empty value */
+        if (len > name_len)
+            *value = strndup(attrs + pos + name_len + 1,
+                             len - name_len - 1);
+        else
+            *value = strdup("");
+        if (*value == NULL)
+            rc = TE_RC(TE_TAPI, TE_ENOMEM);
+    }
+
+    free(attrs);
+    return rc;
+}
+
+/* See description in lib-ts_tune.h */
+te_errno
+libts_tune_set(const char *ta, libts_tune_kind kind, const char *name,
+               const char *value)
+{
+    te_string   result = TE_STRING_INIT;
+    char       *attrs = NULL;
+    te_errno    rc;
+
+    if (kind == LIBTS_TUNE_ENV)
+        return env_set(ta, name, value);
+
+    rc = env_get(ta, LIBTS_TUNE_ZF_ATTR_VAR, &attrs);
+    if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
+    {
+        if (value == NULL)
+            return 0;
+    }
+    else if (rc != 0)
+    {
+        return rc;
+    }
+
+    rc = zf_attr_edit(attrs == NULL ? "" : attrs, name, value, &result);
+    free(attrs);
+    if (rc == 0)
+    {
+        /* Empty list is removed to not leave ZF_ATTR="" */
+        rc = env_set(ta, LIBTS_TUNE_ZF_ATTR_VAR,
+                     result.len == 0 ? NULL : result.ptr);
+    }
+    te_string_free(&result);
+
+    return rc;
+}
+
+/* See description in lib-ts_tune.h */
+const libts_tune_profile *
+libts_tune_profile_find(const char *name)
+{
+    unsigned int i;
+
+    for (i = 0; i < TE_ARRAY_LEN(tune_profiles); i++)
+    {
+        if (strcmp(tune_profiles[i].name, name) == 0)
+            return &tune_profiles[i];
+    }
+
+    return NULL;
+}
+
+/* See description in lib-ts_tune.h */
+te_errno
+libts_tune_apply(const char *ta, const libts_tune_profile *profile,
+                 libts_tune_backup *backup)
+{
+    te_string       log = TE_STRING_INIT;
+    unsigned int    i;
+    te_errno        rc = 0;
+
+    memset(backup, 0, sizeof(*backup));
+    backup->ta = strdup(ta);
+    backup->saved = calloc(profile->n_settings + 1,
+                           sizeof(*backup->saved));
+    if (backup->ta == NULL || backup->saved == NULL)
+    {
+        libts_tune_revert(backup);
+        return TE_RC(TE_TAPI, TE_ENOMEM);
+    }
+
+    for (i = 0; i < profile->n_settings && rc == 0; i++)
+    {
+        const libts_tune_setting   *setting = &profile->settings[i];
+        libts_tune_saved           *saved =
+                                        &backup->saved[backup->n_saved];
+
+        saved->kind = setting->kind;
+        saved->name = strdup(setting->name);
+        if (saved->name == NULL)
+        {
+            rc = TE_RC(TE_TAPI, TE_ENOMEM);
+            break;
+        }
+
+        rc = libts_tune_get(ta, setting->kind, setting->name,
+                            &saved->value);
+        if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
+        {
+            saved->value = NULL;
+            rc = 0;
+        }
+        else if (rc != 0)
+        {
+            free(saved->name);
+            break;
+        }
+        backup->n_saved++;
+
+        rc = libts_tune_set(ta, setting->kind, setting->name,
+                            setting->value);
+        if (rc == 0)
+        {
+            te_string_append(&log, "\n  %s%s: %s -> %s",
+                             setting->kind == LIBTS_TUNE_ZF_ATTR ?
+                                LIBTS_TUNE_ZF_ATTR_VAR ":" : "",
+                             setting->name,
+                             saved->value == NULL ? "(unset)" : saved->value,
+                             setting->value == NULL ? "(unset)" :
+                                                      setting->value);
+        }
+    }
+
+    if (rc != 0)
+    {
+        ERROR("Failed to apply tuning profile '%s' on %s: %r",
+              profile->name, ta, rc);
+        libts_tune_revert(backup);
+    }
+    else
+    {
+        RING("Tuning profile '%s' (%s) is applied on %s:%s", profile->name,
+             profile->descr, ta, log.len == 0 ? "" : log.ptr);
+    }
+    te_string_free(&log);
+
+    return rc;
+}
+
+/* See description in lib-ts_tune.h */
+te_errno
+libts_tune_revert(libts_tune_backup *backup)
+{
+    te_errno    rc = 0;
+    te_errno    rc2;
+
+    /* Settings are reverted in the reverse order */
+    while (backup->n_saved > 0)
+    {
+        libts_tune_saved *saved = &backup->saved[--backup->n_saved];
+
+        rc2 = libts_tune_set(backup->ta, saved->kind, saved->name,
+                             saved->value);
+        if (rc2 != 0)
+        {
+            ERROR("Failed to revert %s on %s: %r", saved->name,
+                  backup->ta, rc2);
+            if (rc == 0)
+                rc = rc2;
+        }
+        free(saved->name);
+        free(saved->value);
+    }
+
+    free(backup->saved);
+    free(backup->ta);
+    memset(backup, 0, sizeof(*backup));
+
+    return rc;
+}
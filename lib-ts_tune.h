@@ -0,0 +1,131 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Onload/ZF tuning API
+ *
+ * Key-aware editing of Onload environment (EF_* variables) and ZF
+ * attributes (ZF_ATTR variable, a list of key=value pairs separated by
+ * ';') of an agent, and named tuning profiles which are applied and
+ * reverted as a whole.
+ *
+ * Settings are read from /local:<agent>/env: configurator subtree and
+ * are changed both in it and in /agent:<agent>/env:, so a change takes
+ * effect for processes started by the agent after it (e.g. RPC servers
+ * created after a profile is applied) even if the prologue has already
+ * copied the former subtree to the latter. Processes which are already
+ * running keep their environment.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_TUNE_H__
+#define __ONLOAD_LIB_TS_TUNE_H__
+
+#include "te_errno.h"
+#include "te_defs.h"
+
+/** Name of the environment variable with ZF attributes */
+#define LIBTS_TUNE_ZF_ATTR_VAR "ZF_ATTR"
+
+/** Kind of a tuning setting */
+typedef enum libts_tune_kind {
+    LIBTS_TUNE_ENV,         /**< Environment variable, e.g. EF_POLL_USEC */
+    LIBTS_TUNE_ZF_ATTR,     /**< Key of ZF_ATTR, e.g. rx_ring_max */
+} libts_tune_kind;
+
+/** Tuning setting */
+typedef struct libts_tune_setting {
+    libts_tune_kind  kind;      /**< Kind of the setting */
+    const char      *name;      /**< Variable name or ZF_ATTR key */
+    const char      *value;     /**< Value or @c NULL to unset */
+} libts_tune_setting;
+
+/** Tuning profile */
+typedef struct libts_tune_profile {
+    const char                 *name;       /**< Profile name */
+    const char                 *descr;      /**< Description */
+    const libts_tune_setting   *settings;   /**< Settings */
+    unsigned int                n_settings; /**< Number of settings */
+} libts_tune_profile;
+
+/** Saved value of a setting */
+typedef struct libts_tune_saved {
+    libts_tune_kind  kind;      /**< Kind of the setting */
+    char            *name;      /**< Variable name or ZF_ATTR key */
+    char            *value;     /**< Value or @c NULL if it was not set */
+} libts_tune_saved;
+
+/** Values of settings saved before a profile is applied */
+typedef struct libts_tune_backup {
+    char               *ta;         /**< Agent name */
+    libts_tune_saved   *saved;      /**< Saved values */
+    unsigned int        n_saved;    /**< Number of saved values */
+} libts_tune_backup;
+
+/** Initializer of an empty backup */
+#define LIBTS_TUNE_BACKUP_INIT { NULL, NULL, 0 }
+
+/**
+ * Get value of a setting.
+ *
+ * @param ta        Agent name.
+ * @param kind      Kind of the setting.
+ * @param name      Variable name or ZF_ATTR key.
+ * @param value     Where to put the value (from the heap).
+ *
+ * @return Status code (@c TE_ENOENT if the setting is not set).
+ */
+extern te_errno libts_tune_get(const char *ta, libts_tune_kind kind,
+                               const char *name, char **value);
+
+/**
+ * Set value of a setting both in /local:<agent>/env: and in
+ * /agent:<agent>/env:. A ZF_ATTR key is replaced in place if it is
+ * already in the list (duplicates are removed), otherwise it is
+ * appended.
+ *
+ * @param ta        Agent name.
+ * @param kind      Kind of the setting.
+ * @param name      Variable name or ZF_ATTR key.
+ * @param value     Value or @c NULL to unset the setting.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_tune_set(const char *ta, libts_tune_kind kind,
+                               const char *name, const char *value);
+
+/**
+ * Find a predefined tuning profile: "latency" (low-latency spinning),
+ * "throughput" (large queues) or "low_memory" (small buffers pool).
+ *
+ * @param name      Profile name.
+ *
+ * @return Profile or @c NULL if it is not found.
+ */
+extern const libts_tune_profile *libts_tune_profile_find(const char *name);
+
+/**
+ * Apply a tuning profile, saving current values of the settings.
+ * If applying fails, the settings already changed are reverted.
+ *
+ * @param ta        Agent name.
+ * @param profile   Profile.
+ * @param backup    Where to save current values (should be reverted
+ *                  with libts_tune_revert()).
+ *
+ * @return Status code.
+ */
+extern te_errno libts_tune_apply(const char *ta,
+                                 const libts_tune_profile *profile,
+                                 libts_tune_backup *backup);
+
+/**
+ * Revert settings saved by libts_tune_apply() and release the backup.
+ *
+ * @param backup    Backup.
+ *
+ * @return Status code.
+ */
+extern te_errno libts_tune_revert(libts_tune_backup *backup);
+
+#endif /* !__ONLOAD_LIB_TS_TUNE_H__ */
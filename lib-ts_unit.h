@@ -0,0 +1,70 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* (c) Copyright 2026 Advanced Micro Devices, Inc. All rights reserved. */
+/** @file
+ * @brief Unit tests helpers
+ *
+ * Helpers for unit tests of engine-side code of lib-ts which does not
+ * talk to agents (statistics, indexes, serialization).
+ *
+ * A unit test lib-ts_<module>_test.c is a program which checks the
+ * module via its API or, to reach static functions, includes the source
+ * of the module and defines fakes of functions the module calls on
+ * agents or configurator. It is built with the same TE headers and
+ * libraries as lib-ts (and linked with lib-ts if it does not include
+ * the module source), and exits with zero status if all checks pass.
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef __ONLOAD_LIB_TS_UNIT_H__
+#define __ONLOAD_LIB_TS_UNIT_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/** Number of failed checks */
+static unsigned int libts_unit_failed = 0;
+
+/**
+ * Check a condition, report it to stderr if it is false.
+ *
+ * @param _cond     Condition.
+ */
+#define LIBTS_UNIT_CHECK(_cond) \
+    do {                                                            \
+        if (!(_cond))                                               \
+        {                                                           \
+            fprintf(stderr, "%s:%d: check failed: %s\n",            \
+                    __FILE__, __LINE__, #_cond);                    \
+            libts_unit_failed++;                                    \
+        }                                                           \
+    } while (0)
+
+/**
+ * Check that two floating point values are equal with an absolute
+ * tolerance.
+ *
+ * @param _a        The first value.
+ * @param _b        The second value.
+ * @param _eps      Tolerance.
+ */
+#define LIBTS_UNIT_CHECK_DOUBLE(_a, _b, _eps) \
+    LIBTS_UNIT_CHECK(fabs((double)(_a) - (double)(_b)) <= (_eps))
+
+/**
+ * Get exit status of a unit test.
+ *
+ * @return @c EXIT_SUCCESS if all checks passed, @c EXIT_FAILURE
+ *         otherwise.
+ */
+static inline int
+libts_unit_result(void)
+{
+    if (libts_unit_failed != 0)
+        fprintf(stderr, "%u checks failed\n", libts_unit_failed);
+
+    return libts_unit_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif /* !__ONLOAD_LIB_TS_UNIT_H__ */